@@ -0,0 +1,142 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+//Header includes
+#include <ht_platform.h> //HT_API
+#include <ht_noncopy.h> //INonCopy
+#include <cstddef> //size_t, ptrdiff_t
+#include <atomic> //std::atomic<T>
+#include <iterator> //std::forward_iterator_tag
+#include <type_traits> //std::aligned_storage<T>, std::is_nothrow_constructible<T, Args...>
+
+//Inline includes
+#include <new> //placement new
+#include <utility> //std::forward
+#include <cassert> //assert()
+#if defined(_MSC_VER)
+#include <intrin.h> //_BitScanReverse64
+#endif
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \class ConcurrentVector<T>
+        \ingroup HatchitCore
+        \brief Append-only vector with lock-free appends and reads
+
+        Elements live in segments which double in size and are never moved,
+        so references to elements stay valid for the lifetime of the vector.
+        push_back reserves a slot with one atomic increment and allocates a
+        new segment with a CAS when it is the first to need it.  Elements
+        become visible in index order: size() only counts the prefix of
+        fully constructed elements, and pushing threads help each other
+        advance it instead of waiting.
+
+        Reads take no lock and return references.  Concurrent writes to the
+        same element must still be synchronized by the caller.
+
+        An element whose constructor may throw is built before its slot is
+        reserved and then moved in, so a throwing constructor never leaves a
+        slot that holds back size().  T must be nothrow move constructible.
+        **/
+        template <typename T>
+        class HT_API ConcurrentVector : public INonCopy
+        {
+            static_assert(std::is_nothrow_move_constructible<T>::value, "ConcurrentVector<T> requires T to be nothrow move constructible");
+
+        private:
+            struct Slot
+            {
+                typename std::aligned_storage<sizeof(T), alignof(T)>::type  m_storage;
+                std::atomic<bool>                                           m_ready;
+            };
+
+        public:
+            template <class Value>
+            class Iterator
+            {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = T;
+                using difference_type = std::ptrdiff_t;
+                using pointer = Value*;
+                using reference = Value&;
+
+                Iterator(const ConcurrentVector* vector, size_t index);
+
+                reference operator*() const;
+                pointer operator->() const;
+                Iterator& operator++();
+                Iterator operator++(int);
+                bool operator==(const Iterator& rhs) const;
+                bool operator!=(const Iterator& rhs) const;
+
+            private:
+                const ConcurrentVector* m_vector;
+                size_t                  m_index;
+            };
+
+            using iterator = Iterator<T>;
+            using const_iterator = Iterator<const T>;
+
+            ConcurrentVector();
+            ~ConcurrentVector();
+
+            size_t push_back(const T& _val);
+            size_t push_back(T&& _val);
+
+            template <class... Args>
+            size_t emplace_back(Args&&... arguments);
+
+            T& operator[](size_t pos);
+            const T& operator[](size_t pos) const;
+
+            iterator begin();
+            iterator end();
+            const_iterator begin() const;
+            const_iterator end() const;
+
+            size_t size() const;
+            bool empty() const;
+
+        private:
+            static const size_t FirstSegmentBits = 5;
+            static const size_t SegmentCount = sizeof(size_t) * 8 - FirstSegmentBits;
+
+            static size_t HighestBit(size_t value);
+            static size_t SegmentOf(size_t index, size_t& offset);
+            static size_t SegmentSize(size_t segment);
+
+            template <class... Args>
+            size_t Emplace(std::true_type, Args&&... arguments);
+
+            template <class... Args>
+            size_t Emplace(std::false_type, Args&&... arguments);
+
+            Slot& GetSlot(size_t index) const;
+            Slot& AcquireSlot(size_t index);
+            void Commit();
+
+            std::atomic<Slot*>  m_segments[SegmentCount];
+            std::atomic<size_t> m_reserved;
+            std::atomic<size_t> m_size;
+        };
+    }
+}
+
+#include <ht_concurrentvector.inl>
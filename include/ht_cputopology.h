@@ -0,0 +1,65 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_platform.h> //HT_API
+#include <stdint.h> //uint32_t
+#include <vector> //std::vector<T>
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \class CpuTopology
+        \ingroup HatchitCore
+        \brief Describes the logical processors available to the process.
+
+        Every logical processor records the physical core, package and NUMA
+        node it belongs to.  On Linux the topology is read from
+        /sys/devices/system/cpu, other platforms report every hardware
+        thread as its own core on node 0.  A topology may also be built by
+        hand with AddProcessor.
+        **/
+        class HT_API CpuTopology
+        {
+        public:
+            struct Processor
+            {
+                uint32_t m_id;
+                uint32_t m_core;
+                uint32_t m_package;
+                uint32_t m_node;
+            };
+
+            CpuTopology();
+
+            static CpuTopology Detect();
+
+            static bool PinCurrentThread(uint32_t processor);
+
+            void AddProcessor(const Processor& processor);
+
+            const std::vector<Processor>& GetProcessors() const;
+
+            std::vector<uint32_t> GetNodes() const;
+
+            bool IsEmpty() const;
+
+        private:
+            std::vector<Processor> m_processors;
+        };
+    }
+}
@@ -17,6 +17,7 @@
 //Header includes
 #include <ht_platform.h> //HT_API
 #include <stdint.h> //uint8_t & uint64_t typedef
+#include <cstddef> //size_t
 #include <string> //std::string typedef
 
 namespace Hatchit
@@ -24,11 +25,41 @@ namespace Hatchit
     namespace Core
     {
 
+        /**
+         * \class GuidLiteral
+         * \ingroup HatchitCore
+         *
+         * \brief String Guid whose hashes are computed at compile time.
+         *
+         * Produced by the _guid literal, i.e. "textures/grass"_guid, and
+         * converted to the Guid that Guid::FromString would return for the
+         * same text.  Declare it constexpr to guarantee no hashing happens at
+         * runtime.  Hashes are laid out for little-endian targets.
+         */
+        struct HT_API GuidLiteral
+        {
+            constexpr GuidLiteral(const char* text, size_t length);
+
+            static constexpr uint64_t GetFnv1aHash(const char* text, size_t length, uint64_t hash);
+            static constexpr uint64_t GetFnv1aHash(uint64_t first, uint64_t second, int index, uint64_t hash);
+
+            uint64_t    m_first;
+            uint64_t    m_second;
+            uint64_t    m_hashCode;
+            const char* m_text;
+            size_t      m_length;
+        };
+
+        constexpr GuidLiteral operator"" _guid(const char* text, size_t length);
+
         /**
          * \class Guid
          * \ingroup HatchitCore
          *
          * \brief Defines a simple globally-unique identifier.
+         *
+         * The original string of Guids created from strings is only kept in
+         * debug builds, so release Guids never allocate.
          */
         class HT_API Guid
         {
@@ -46,6 +77,8 @@ namespace Hatchit
 
             Guid();
 
+            Guid(const GuidLiteral& literal);
+
             Guid(const Guid& other);
 
             Guid(Guid&& other);
@@ -76,10 +109,15 @@ namespace Hatchit
 
 
         private:
+            Guid(uint64_t first, uint64_t second, uint64_t hashCode, const char* text, size_t length);
+
             //Private Variables
             uint8_t m_uuid[16];
             uint64_t m_hashCode;
+            bool m_fromString;
+#if defined(_DEBUG) || defined(DEBUG)
             std::string m_originalString;
+#endif
         };
 
     }
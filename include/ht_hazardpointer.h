@@ -0,0 +1,72 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+//Header includes
+#include <ht_platform.h> //HT_API
+#include <ht_noncopy.h> //INonCopy
+#include <stdint.h> //uint32_t
+#include <atomic> //std::atomic<T>
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \class HazardPointer
+        \ingroup HatchitCore
+        \brief Safe memory reclamation for lock-free data structures
+
+        A HazardPointer publishes that the calling thread is about to read
+        through a pointer loaded from shared memory.  Objects unlinked from a
+        data structure are handed to Retire instead of being deleted; they are
+        only deleted once no hazard pointer refers to them any more.
+
+        Every thread may hold up to SlotsPerThread hazard pointers at once.
+        Retired objects are scanned in batches, and objects still retired
+        when a thread exits are adopted by the next thread that scans.
+        **/
+        class HT_API HazardPointer : public INonCopy
+        {
+        public:
+            static const uint32_t SlotsPerThread = 4;
+
+            using Deleter = void(*)(void*);
+
+            HazardPointer();
+            ~HazardPointer();
+
+            template <typename T>
+            T* protect(const std::atomic<T*>& source);
+
+            void reset();
+
+            static void Retire(void* pointer, Deleter deleter);
+
+            template <typename T>
+            static void Retire(T* pointer);
+
+            static void Scan();
+
+        private:
+            template <typename T>
+            static void Delete(void* pointer);
+
+            std::atomic<void*>* m_slot;
+        };
+    }
+}
+
+#include <ht_hazardpointer.inl>
@@ -0,0 +1,81 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+//Header includes
+#include <ht_platform.h> //HT_API
+#include <ht_noncopy.h> //INonCopy
+#include <stdint.h> //uint32_t
+#include <vector> //std::vector<T>
+#include <atomic> //std::atomic<T>
+#include <memory> //std::unique_ptr<T>
+#include <functional> //std::function<T>
+
+//Inline includes
+#include <utility> //std::forward
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \class JobGraph
+        \ingroup HatchitCore
+        \brief Directed acyclic graph of jobs.
+
+        Jobs are added to the graph and ordered by declaring predecessors.
+        Once handed to Scheduler::ScheduleGraph, every job is released to the
+        workers as soon as all of its predecessors have finished, so
+        independent chains overlap instead of running phase by phase.  The
+        graph must outlive its execution and must not be modified while it
+        is running.  A finished graph may be scheduled again.
+        **/
+        class HT_API JobGraph : public INonCopy
+        {
+        public:
+            using NodeID = uint32_t;
+
+            JobGraph();
+            ~JobGraph();
+
+            template <class Func, class... Args>
+            NodeID AddJob(Func&& function, Args&&... arguments);
+
+            void AddDependency(NodeID predecessor, NodeID successor);
+
+            bool HasCycle() const;
+
+            size_t size() const;
+
+        private:
+            friend class Scheduler;
+            friend class GraphJob;
+
+            struct Node
+            {
+                std::function<void()>   m_function;
+                std::vector<NodeID>     m_successors;
+                uint32_t                m_predecessorCount;
+            };
+
+            std::vector<Node>                           m_nodes;
+            std::unique_ptr<std::atomic<uint32_t>[]>    m_remaining;
+
+            NodeID AddNode(std::function<void()> function);
+        };
+    }
+}
+
+#include <ht_jobgraph.inl>
@@ -0,0 +1,46 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+//Header includes
+#include <ht_platform.h> //HT_API
+#include <cstddef> //size_t
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \class JobPool
+        \ingroup HatchitCore
+        \brief Fixed-size block allocator backing scheduler jobs and counters.
+
+        Each thread keeps a local cache of free blocks.  Threads which free
+        more blocks than they allocate hand whole batches back to a shared
+        list, where allocating threads pick them up again, so submitting
+        jobs performs no heap allocation in steady state.  Requests larger
+        than BlockSize fall through to the global heap.  Memory obtained from
+        the heap for blocks is retained for the lifetime of the process.
+        **/
+        class HT_API JobPool
+        {
+        public:
+            static const size_t BlockSize = 128;
+
+            static void* Allocate(size_t size);
+            static void Free(void* block, size_t size);
+        };
+    }
+}
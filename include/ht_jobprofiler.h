@@ -0,0 +1,131 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_platform.h> //HT_API
+#include <ht_noncopy.h> //INonCopy
+#include <stdint.h> //uint32_t, uint64_t
+#include <atomic> //std::atomic<T>
+#include <memory> //std::unique_ptr<T>
+#include <string> //std::string
+#include <vector> //std::vector<T>
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        enum class JobPriority : uint32_t;
+
+        /**
+        \struct JobEvent
+        \ingroup HatchitCore
+        \brief Timing of one job run by the Scheduler.
+
+        Times are in nanoseconds from JobProfiler::Now.  m_worker is -1 for
+        jobs run by threads outside the worker pool while they wait.
+        **/
+        struct HT_API JobEvent
+        {
+            uint64_t    m_enqueueTime;
+            uint64_t    m_startTime;
+            uint64_t    m_endTime;
+            int32_t     m_worker;
+            JobPriority m_priority;
+        };
+
+        /**
+        \struct WorkerStats
+        \ingroup HatchitCore
+        \brief Counters of one Scheduler worker, times in nanoseconds.
+        **/
+        struct HT_API WorkerStats
+        {
+            uint64_t m_jobsRun;
+            uint64_t m_steals;
+            uint64_t m_busyTime;
+            uint64_t m_idleTime;
+        };
+
+        /**
+        \struct SchedulerStats
+        \ingroup HatchitCore
+        \brief Snapshot of the Scheduler counters.
+
+        Queue depths are indexed by JobPriority.  m_queueDepth counts jobs
+        waiting to run at the time of the snapshot, m_peakQueueDepth the
+        most released jobs seen waiting at once.  m_droppedEvents counts
+        events overwritten before they could be collected.
+        **/
+        struct HT_API SchedulerStats
+        {
+            std::vector<WorkerStats>    m_workers;
+            std::vector<uint32_t>       m_queueDepth;
+            std::vector<uint32_t>       m_peakQueueDepth;
+            uint64_t                    m_droppedEvents;
+        };
+
+        /**
+        \class JobEventRing
+        \ingroup HatchitCore
+        \brief Fixed size ring of the most recent JobEvents.
+
+        Recording never blocks or allocates; once the ring is full the
+        oldest events are overwritten.  Every slot is guarded by a sequence
+        number, so events may be collected while they are being recorded and
+        torn events are skipped.
+        **/
+        class HT_API JobEventRing : public INonCopy
+        {
+        public:
+            static const uint64_t Capacity = 4096;
+
+            JobEventRing();
+
+            void Record(const JobEvent& event);
+
+            void Collect(std::vector<JobEvent>& events) const;
+
+            uint64_t GetDroppedCount() const;
+
+        private:
+            struct Slot
+            {
+                std::atomic<uint64_t> m_sequence;
+                std::atomic<uint64_t> m_enqueueTime;
+                std::atomic<uint64_t> m_startTime;
+                std::atomic<uint64_t> m_endTime;
+                std::atomic<uint64_t> m_source;
+            };
+
+            std::unique_ptr<Slot[]> m_slots;
+            std::atomic<uint64_t>   m_next;
+        };
+
+        /**
+        \class JobProfiler
+        \ingroup HatchitCore
+        \brief Clock and exporters for Scheduler profiling data.
+        **/
+        class HT_API JobProfiler
+        {
+        public:
+            static uint64_t Now();
+
+            static std::string ToChromeTrace(const std::vector<JobEvent>& events);
+
+            static bool ExportChromeTrace(const std::vector<JobEvent>& events, const std::string& path);
+        };
+    }
+}
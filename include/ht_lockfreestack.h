@@ -0,0 +1,103 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+//Header includes
+#include <ht_platform.h> //HT_API
+#include <ht_noncopy.h> //INonCopy
+#include <ht_hazardpointer.h> //HazardPointer
+#include <atomic> //std::atomic<T>
+#include <memory> //std::shared_ptr<T>
+#include <cstddef> //size_t
+
+//Inline includes
+#include <exception> //std::exception
+#include <utility> //std::move
+#include <new> //placement new, ::operator new
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \class LockFreeStack<T>
+        \ingroup HatchitCore
+        \brief Lock-free Treiber stack with the interface of ThreadsafeStack
+
+        Nodes are pushed and popped with a single CAS on the head.  Popped
+        nodes are reclaimed through HazardPointer, which also rules out the
+        ABA problem, since a node cannot be reused while another thread is
+        still looking at it.  Reclaimed nodes go to a small per-thread cache
+        that later pushes on that thread take them from, so threads which
+        both push and pop stop allocating once warmed up.  Like
+        ThreadsafeStack, pop throws when the stack is empty; try_pop reports
+        it instead.
+        **/
+        template <typename T>
+        class HT_API LockFreeStack : public INonCopy
+        {
+        public:
+            LockFreeStack();
+            ~LockFreeStack();
+
+            void push(T _val);
+
+            std::shared_ptr<T> pop();
+            void pop(T& _val);
+            bool try_pop(T& _val);
+
+            bool empty() const;
+
+        private:
+            /**
+            \brief Most reclaimed nodes a thread keeps for reuse.
+            **/
+            static const size_t NodeCacheSize = 64;
+
+            struct Node
+            {
+                T       m_value;
+                Node*   m_next;
+            };
+
+            enum class CacheState
+            {
+                Unused,
+                Alive,
+                Destroyed
+            };
+
+            struct NodeCache
+            {
+                explicit NodeCache(CacheState& state);
+                ~NodeCache();
+
+                void*       m_blocks[NodeCacheSize];
+                size_t      m_count;
+                CacheState& m_state;
+            };
+
+            static NodeCache* GetNodeCache(bool create);
+            static Node* CreateNode(T&& value, Node* next);
+            static void DestroyNode(void* node);
+
+            Node* PopNode();
+
+            std::atomic<Node*> m_head;
+        };
+    }
+}
+
+#include <ht_lockfreestack.inl>
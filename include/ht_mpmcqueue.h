@@ -0,0 +1,100 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+//Header includes
+#include <ht_platform.h> //HT_API
+#include <ht_noncopy.h> //INonCopy
+#include <stdint.h> //uint32_t
+#include <cstddef> //size_t
+#include <atomic> //std::atomic<T>
+#include <memory> //std::unique_ptr<T>
+#include <mutex> //std::mutex
+#include <condition_variable> //std::condition_variable
+#include <type_traits> //std::aligned_storage<T>
+
+//Inline includes
+#include <new> //placement new
+#include <utility> //std::move
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \class MPMCQueue<T>
+        \ingroup HatchitCore
+        \brief Bounded lock-free multi-producer multi-consumer queue
+
+        Ring of cells which each carry a sequence number telling producers
+        and consumers whose turn it is, after Dmitry Vyukov's bounded MPMC
+        queue.  try_push and try_pop never block and never allocate; each
+        costs one CAS on the shared position in the common case.
+
+        push and wait_pop block while the queue is full or empty.  Blocked
+        threads sleep on a condition variable which the other side only
+        touches while someone is actually waiting.
+        **/
+        template <typename T>
+        class HT_API MPMCQueue : public INonCopy
+        {
+        public:
+            explicit MPMCQueue(size_t capacity = 1024);
+            ~MPMCQueue();
+
+            bool try_push(const T& _val);
+            bool try_push(T&& _val);
+            bool try_pop(T& out);
+
+            void push(T _val);
+            void wait_pop(T& out);
+
+            bool empty() const;
+            size_t capacity() const;
+
+        private:
+            struct Cell
+            {
+                std::atomic<size_t>                                         m_sequence;
+                typename std::aligned_storage<sizeof(T), alignof(T)>::type  m_storage;
+            };
+
+            template <class U>
+            bool Enqueue(U&& value);
+            template <class U>
+            bool Enqueue(U&& value, std::true_type);
+            template <class U>
+            bool Enqueue(U&& value, std::false_type);
+
+            bool CanPush() const;
+            bool CanPop() const;
+
+            void NotifyProducers();
+            void NotifyConsumers();
+
+            std::unique_ptr<Cell[]>             m_cells;
+            size_t                              m_mask;
+            alignas(64) std::atomic<size_t>     m_enqueuePos;
+            alignas(64) std::atomic<size_t>     m_dequeuePos;
+            alignas(64) std::atomic<uint32_t>   m_waitingProducers;
+            std::atomic<uint32_t>               m_waitingConsumers;
+            std::mutex                          m_mutex;
+            std::condition_variable             m_notFull;
+            std::condition_variable             m_notEmpty;
+        };
+    }
+}
+
+#include <ht_mpmcqueue.inl>
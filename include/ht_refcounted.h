@@ -17,8 +17,10 @@
 //Handle Header includes
 #include <stdint.h> //uint32_t typedef
 #include <typeinfo>
-#include <mutex>
-#include <ht_guid.h>
+#include <atomic> //std::atomic<T>
+#include <ht_refcountedbase.h> //RefCountedBase
+#include <ht_scheduler.h> //JobHandle, Scheduler
+#include <type_traits> //std::is_base_of<T, U>
 #include <ht_platform.h> //HT_API
 
 //Handle Inline includes
@@ -27,8 +29,12 @@
 //RefCounted Header includes
 #include <stdint.h> //uint32_t typedef
 #include <string> //const std::string typedef
+#include <unordered_map> //std::unordered_map<T, U>
+#include <mutex> //std::mutex
 #include <ht_noncopy.h> //INonCopy interface
 #include <ht_platform.h> //HT_API
+#include <ht_slabpool.h> //UseSlabPool<T>, SlabPool<T>
+#include <cstddef> //size_t
 
 //RefCounted Inline includes
 #include <ht_refcounted_resourcemanager.h> //GetRawPointer
@@ -40,6 +46,9 @@ namespace Hatchit
     {
         template<typename VarType>
         class RefCounted;
+
+        template<typename VarType>
+        class IntrusiveHandle;
     }
 }
 
@@ -53,7 +62,10 @@ namespace Hatchit
         \brief Smart pointer to Ref-counted classes
 
         Handle contains pointer to RefCounted class.  Handles reference counting
-        and release of refcounted resources.
+        and release of refcounted resources.  A handle is two pointers wide:
+        the resource as VarType, and its RefCountedBase.  Handles returned by
+        RefCounted<T>::GetHandleAsync point at a placeholder until their
+        resource has loaded, then at the resource.
         **/
         template<typename VarType>
         class HT_API Handle
@@ -83,6 +95,8 @@ namespace Hatchit
 
 
             bool IsValid() const;
+            bool IsLoaded() const;
+            JobHandle GetLoadJob() const;
             void Release();
 
         private:
@@ -91,14 +105,63 @@ namespace Hatchit
             template<typename NewVarType>
             friend class Handle;
 
-            Handle(VarType* varPtr, uint32_t* refCounter, const Guid* name);
+            friend class IntrusiveHandle<VarType>;
+
+            Handle(VarType* varPtr, RefCountedBase* counted, bool addReference = true);
+
+            void ReleaseReference();
+            VarType* Resolve(std::true_type) const;
+            VarType* Resolve(std::false_type) const;
 
             //Private members
-            VarType*    m_ptr;
-            uint32_t*   m_refCount;
-            const Guid* m_ID;
+            VarType*        m_ptr;
+            RefCountedBase* m_counted;
+        };
+
+        /**
+        \class IntrusiveHandle<T>
+        \ingroup HatchitCore
+        \brief Single pointer handle to Ref-counted classes
+
+        Keeps the resource alive like Handle, but holds nothing except the
+        pointer to it and reaches the count and ID through its
+        RefCountedBase.  Meant for large arrays of handles, where it halves
+        the memory of Handle.  It cannot refer to a placeholder standing in
+        for a resource that is still loading, nor be cast to other types;
+        convert it to a Handle for that.
+        **/
+        template<typename VarType>
+        class HT_API IntrusiveHandle
+        {
+        public:
+            IntrusiveHandle();
+            explicit IntrusiveHandle(const Handle<VarType>& handle);
+            IntrusiveHandle(const IntrusiveHandle& rhs);
+            IntrusiveHandle(IntrusiveHandle&& rhs);
+            ~IntrusiveHandle();
+
+            //Public Methods
+            IntrusiveHandle& operator=(const IntrusiveHandle& rhs);
+            IntrusiveHandle& operator=(IntrusiveHandle&& rhs);
+
+            VarType* operator->() const;
+
+            bool operator>(const IntrusiveHandle<VarType>& rhs) const;
+            bool operator<(const IntrusiveHandle<VarType>& rhs) const;
+            bool operator==(const IntrusiveHandle<VarType>& rhs) const;
+            bool operator!=(const IntrusiveHandle<VarType>& rhs) const;
+
+            Handle<VarType> GetHandle() const;
+            const Guid& GetID() const;
 
-            mutable std::mutex m_mutex;
+            bool IsValid() const;
+            void Release();
+
+        private:
+            void ReleaseReference();
+
+            //Private members
+            VarType*    m_ptr;
         };
 
         /**
@@ -109,35 +172,63 @@ namespace Hatchit
         RefCounted class describes class that manages its memory via
         handles.  Once there are no handles left to the instance, it
         releases itself.
+
+        Types for which UseSlabPool<T> is specialized as std::true_type are
+        allocated from SlabPool<T> instead of the global heap.
+
+        The ID a name maps to is computed once per type and interned, but
+        the string overloads still lock and hash to find it on every call.
+        Hot paths should keep the Guid returned by GetIDFromName and use the
+        Guid overloads, which neither allocate nor hash strings.
         **/
         template<typename VarType>
-        class HT_API RefCounted : public INonCopy
+        class HT_API RefCounted : public RefCountedBase
         {
         public:
             RefCounted() = default;
-            RefCounted(RefCounted&&) = default;
             virtual ~RefCounted() = default;
 
             //Public Methods
-            RefCounted& operator=(RefCounted&&) = default;
 
             template <typename... Args>
-            static Handle<VarType> GetHandle(std::string name, Args&&... args);
+            static Handle<VarType> GetHandle(const std::string& name, Args&&... args);
 
             template <typename... Args>
-            static Handle<VarType> GetHandleAsync(Handle<VarType> _default, std::string name, Args&&... args);
+            static Handle<VarType> GetHandle(const Guid& ID, Args&&... args);
+
+            static Handle<VarType> GetHandle(const SlotHandle& slot);
+
+            template <typename... Args>
+            static Handle<VarType> GetHandleAsync(Handle<VarType> _default, const std::string& name, Args&&... args);
+
+            template <typename... Args>
+            static Handle<VarType> GetHandleAsync(Handle<VarType> _default, const Guid& ID, Args&&... args);
+
+            static const Guid& GetIDFromName(const std::string& name);
+
+            static void* operator new(size_t size);
+            static void operator delete(void* block, size_t size);
 
         protected:
             friend class RefCountedResourceManager;
 
+            template <typename... Args>
+            static void LoadAsync(Handle<VarType> handle, Handle<VarType> _default, Args... args);
+
             RefCounted(Guid ID);
 
         private:
-            uint32_t    m_refCount;
-            const Guid  m_ID;
+            struct NameTable
+            {
+                std::mutex                              m_mutex;
+                std::unordered_map<std::string, Guid>   m_IDs;
+            };
+
+            static NameTable& GetNameTable();
         };
     }
 }
 
 #include <ht_handle.inl>
+#include <ht_intrusivehandle.inl>
 #include <ht_refcounted.inl>
@@ -17,11 +17,19 @@
 //Header Includes
 #include <ht_platform.h> //HT_API
 #include <ht_singleton.h> //Singleton<T>
-#include <map> //std::map<T, U>
+#include <unordered_map> //std::unordered_map<T, U>
+#include <mutex> //std::mutex
+#include <atomic> //std::atomic<T>
+#include <stdint.h> //uint32_t
+#include <cstddef> //size_t
 
 //Inline includes
 #include <ht_guid.h> //Guid
+#include <ht_refcountedbase.h> //RefCountedBase
+#include <ht_slotmap.h> //SlotMap<T>, SlotHandle, UseSlotMap<T>
+#include <ht_scheduler.h> //Scheduler::WaitFor
 #include <cassert> //assert()
+#include <vector> //std::vector<T>
 
 namespace Hatchit
 {
@@ -33,7 +41,27 @@ namespace Hatchit
         \brief Singleton that manages allocation and freeing of RefCounted resources.
 
         Singleton that manages allocation and freeing of RefCounted resources
-        via Guid ID.
+        via Guid ID.  Resources are spread over independently locked shards
+        picked by Guid::GetHashCode(), so threads loading different
+        resources rarely contend.  Resources are constructed and initialized
+        outside any lock.
+
+        In deferred release mode, resources whose last reference is dropped
+        stay stored and are destroyed by the next call to FlushReleases,
+        instead of on whichever thread dropped them.  FlushReleases may be
+        called at a safe point such as the end of a frame, or scheduled as
+        a Background job.  A resource handed out again before the flush is
+        kept alive.
+
+        Resources of types opted into UseSlotMap<T> are also registered in
+        a SlotMap of that type.  ForEachResource iterates it densely, and
+        their SlotHandles can be turned back into resources with a cheap
+        validity check.  Resources are stored by pointer, since handles
+        point at them and they must not move.
+
+        Resources are stored, released and destroyed through their
+        RefCountedBase, so a resource may be released through a handle cast
+        to any of its base classes.
         **/
         class HT_API RefCountedResourceManager 
             : public Singleton<RefCountedResourceManager>
@@ -53,10 +81,64 @@ namespace Hatchit
             template<typename ResourceType>
             static void ReleaseRawPointer(const Guid& name);
 
+            template<typename ResourceType>
+            static ResourceType* GetRawPointerFromSlot(const SlotHandle& slot);
+
+            template<typename ResourceType, typename Func>
+            static void ForEachResource(Func&& function);
+
+            static void SetDeferredRelease(bool deferred);
+            static bool IsDeferredRelease();
+            static size_t FlushReleases();
+
         private:
+            static const uint32_t ShardCount = 64;
+
+            struct alignas(64) Shard
+            {
+                std::mutex                                  m_mutex;
+                std::unordered_map<Guid, RefCountedBase*>   m_resources;
+            };
+
             static RefCountedResourceManager& GetInstance();
 
-            std::map<Guid, void*>     m_resources;
+            static Shard& GetShard(const Guid& ID);
+
+            template<typename ResourceType>
+            static ResourceType* Find(Shard& shard, const Guid& ID);
+
+            template<typename ResourceType>
+            static ResourceType* Insert(Shard& shard, const Guid& ID, ResourceType* resource);
+
+            template<typename ResourceType>
+            static ResourceType* WaitForLoad(ResourceType* resource);
+
+            template<typename ResourceType>
+            struct TypeSlots
+            {
+                std::mutex              m_mutex;
+                SlotMap<ResourceType*>  m_resources;
+            };
+
+            template<typename ResourceType>
+            static TypeSlots<ResourceType>& GetTypeSlots();
+
+            template<typename ResourceType>
+            static void AddSlot(ResourceType* resource);
+
+            template<typename ResourceType>
+            static void EraseSlot(RefCountedBase* resource);
+
+            static void RemoveSlot(RefCountedBase* resource);
+
+            static void Release(const Guid& ID);
+
+            static void Retire(const Guid& ID);
+
+            static bool ReleaseRetired(const Guid& ID);
+
+            Shard               m_shards[ShardCount];
+            std::atomic<bool>   m_deferredRelease;
         };
     }
 }
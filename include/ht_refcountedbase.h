@@ -0,0 +1,112 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#pragma once
+
+//Header includes
+#include <stdint.h> //uint32_t typedef
+#include <atomic> //std::atomic<T>
+#include <ht_guid.h> //Guid
+#include <ht_slotmap.h> //SlotHandle
+#include <ht_scheduler.h> //JobHandle
+#include <ht_noncopy.h> //INonCopy interface
+#include <ht_platform.h> //HT_API
+#include <typeinfo> //std::type_info
+
+//Inline includes
+#include <thread> //std::this_thread::yield
+
+//Forward declaractions
+namespace Hatchit
+{
+    namespace Core
+    {
+        class RefCountedResourceManager;
+
+        template<typename VarType>
+        class RefCounted;
+    }
+}
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \class RefCountedBase
+        \ingroup HatchitCore
+        \brief Reference count and ID shared by every RefCounted type.
+
+        Handles reach the count and ID of the resource they keep alive
+        through this class, whatever type they have been cast to.  The
+        count is atomic, so handles may be copied and destroyed on any
+        thread.  Resources of types opted into UseSlotMap<T> also know the
+        SlotHandle they are registered under.  The load state tells handles
+        to a resource loaded by GetHandleAsync when to stop using their
+        placeholder.  The type a resource was stored as is remembered, so
+        it is not handed out as another type under the same ID.
+        **/
+        class HT_API RefCountedBase : public INonCopy
+        {
+        public:
+            const Guid& GetID() const;
+            const SlotHandle& GetSlot() const;
+
+            void AddReference();
+            bool RemoveReference();
+            uint32_t GetReferenceCount() const;
+
+            bool IsLoaded() const;
+            JobHandle GetLoadJob() const;
+
+        protected:
+            RefCountedBase();
+            explicit RefCountedBase(Guid ID);
+            virtual ~RefCountedBase() = default;
+
+        private:
+            friend class RefCountedResourceManager;
+
+            template<typename VarType>
+            friend class RefCounted;
+
+            using SlotRemover = void(*)(RefCountedBase* resource);
+
+            enum LoadState : uint32_t
+            {
+                LoadScheduled = 1,
+                LoadJobPublished = 2,
+                Loaded = 4,
+                LoadFailed = 8
+            };
+
+            bool TryAddReference();
+            bool RemoveLastReference();
+            bool TryScheduleLoad(uint32_t& state);
+            void PublishLoadJob(JobHandle job);
+            void CompleteLoad(bool succeeded);
+
+            std::atomic<uint32_t>   m_refCount;
+            std::atomic<uint32_t>   m_loadState;
+            const Guid              m_ID;
+            SlotHandle              m_slot;
+            SlotRemover             m_removeSlot;
+            JobHandle               m_loadJob;
+            const std::type_info*   m_type;
+        };
+    }
+}
+
+#include <ht_refcountedbase.inl>
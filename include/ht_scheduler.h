@@ -19,49 +19,185 @@
 //Header includes
 #include <ht_platform.h> //HT_API
 #include <ht_singleton.h> //Singleton<T>
+#include <ht_workstealingdeque.h> //WorkStealingDeque<T>
+#include <ht_jobpool.h> //JobPool
+#include <ht_cputopology.h> //CpuTopology
+#include <ht_jobprofiler.h> //JobEventRing, SchedulerStats
 #include <stdint.h> //uint32_t
-#include <queue> //std::queue<T>
+#include <vector> //std::vector<T>
+#include <thread> //std::thread
+#include <mutex> //std::mutex
+#include <condition_variable> //std::condition_variable
+#include <atomic> //std::atomic<T>
+#include <memory> //std::unique_ptr<T>
+#include <cstddef> //size_t, std::max_align_t
+#include <string> //std::string
 
 //Inline includes
-#include <functional> //std::function<T>
+#include <type_traits> //std::decay<T>
+#include <new> //placement new
+#include <tuple> //std::tuple<T...>
+#include <utility> //std::index_sequence<I...>
 
 //Forward declarations
-namespace std
+namespace Hatchit
 {
-    class thread;
+    namespace Core
+    {
+        class JobGraph;
+        class TaskDispatcher;
+    }
 }
 
 namespace Hatchit
 {
     namespace Core
     {
+        /**
+        \enum JobPriority
+        \ingroup HatchitCore
+        \brief Priority class of a scheduled job.
+
+        High is meant for latency critical per-frame work, Background for
+        streaming and other work that may be delayed.
+        **/
+        enum class JobPriority : uint32_t
+        {
+            High,
+            Normal,
+            Background
+        };
+
+        /**
+        \struct SchedulerConfig
+        \ingroup HatchitCore
+        \brief Options for Scheduler::Initialize.
+
+        m_pinWorkers pins every worker to one logical processor, using every
+        physical core before any of their hyperthreads.  m_groupByNode fills
+        the processors of one NUMA node before moving on to the next, and
+        makes idle workers steal from workers on their own node first, so
+        jobs spawned on a node tend to stay there.  If either option is set
+        and m_topology is empty, CpuTopology::Detect is used.
+        **/
+        struct HT_API SchedulerConfig
+        {
+            SchedulerConfig();
+
+            uint32_t    m_workerCount;
+            uint32_t    m_highPriorityWorkers;
+            bool        m_pinWorkers;
+            bool        m_groupByNode;
+            CpuTopology m_topology;
+        };
+
+        /**
+        \class JobHandle
+        \ingroup HatchitCore
+        \brief Lightweight reference to the completion counter of a scheduled job.
+
+        Returned by Scheduler::ScheduleJob.  Copies share the same counter, which
+        is released once the job and every handle to it are gone.
+        **/
+        class HT_API JobHandle
+        {
+        public:
+            JobHandle();
+            JobHandle(const JobHandle& rhs);
+            JobHandle(JobHandle&& rhs);
+            ~JobHandle();
+
+            JobHandle& operator=(const JobHandle& rhs);
+            JobHandle& operator=(JobHandle&& rhs);
+
+            bool IsValid() const;
+            bool IsComplete() const;
+
+        private:
+            friend class Scheduler;
+
+            struct Counter
+            {
+                std::atomic<uint32_t> m_remaining;
+                std::atomic<uint32_t> m_references;
+
+                static void* operator new(size_t size) { return JobPool::Allocate(size); }
+                static void operator delete(void* block, size_t size) { JobPool::Free(block, size); }
+            };
+
+            explicit JobHandle(Counter* counter);
+
+            Counter* m_counter;
+        };
+
         /**
         \interface IJob
         \ingroup HatchitCore
         \brief Interface for threading job.
+
+        Jobs are allocated from the JobPool rather than the global heap.
         **/
         class HT_API IJob
         {
         public:
+            IJob() : m_enqueueTime(0) {}
             virtual ~IJob() = default;
 
-            virtual std::thread GetThread() = 0;
+            virtual void Run() = 0;
+
+            static void* operator new(size_t size);
+            static void operator delete(void* block, size_t size);
+
+        private:
+            friend class Scheduler;
+
+            uint64_t m_enqueueTime;
         };
 
         /**
         \class Job
         \ingroup HatchitCore
         \brief Describes a function to be threaded.
+
+        Callables of up to StorageSize bytes are stored inside the job itself;
+        larger callables are moved to the heap.  Exceptions escaping the
+        callable are logged and do not stop the job from completing.
         **/
         class HT_API Job : public IJob
         {
         public:
-            Job(std::function<void()> function);
+            static const size_t StorageSize = 64;
+
+            template <class Func>
+            Job(Func&& function, JobHandle handle = JobHandle());
+            ~Job();
 
-            std::thread GetThread() override;
+            Job(const Job&) = delete;
+            Job& operator=(const Job&) = delete;
+
+            void Run() override;
 
         private:
-            std::function<void()> m_function;
+            using InvokeFunc = void(*)(void*);
+            using DestroyFunc = void(*)(void*, bool);
+
+            template <class Callable, class Func>
+            void Store(Func&& function, std::true_type);
+
+            template <class Callable, class Func>
+            void Store(Func&& function, std::false_type);
+
+            template <class Func>
+            static void Invoke(void* callable);
+
+            template <class Func>
+            static void Destroy(void* callable, bool inlined);
+
+            alignas(std::max_align_t) unsigned char m_storage[StorageSize];
+            void*                                   m_callable;
+            InvokeFunc                              m_invoke;
+            DestroyFunc                             m_destroy;
+            JobHandle                               m_handle;
         };
 
         /**
@@ -71,7 +207,22 @@ namespace Hatchit
         * \brief A manager that schedules and submits jobs to threads as they are available
         *
         * Supply this manager with function pointers (jobs) and it should schedule and sync these
-        * jobs appropriately across however many threads are on the hardware.
+        * jobs appropriately across however many threads are on the hardware.  Jobs are executed
+        * by a pool of long-lived worker threads which sleep while there is no work available.
+        *
+        * Each worker owns a work-stealing deque.  Jobs scheduled from inside a running job are
+        * pushed onto the local deque and run without waiting for RunJobs.  Idle workers steal
+        * from randomly chosen victims before falling back to the shared queue.
+        *
+        * Every JobPriority has its own deques and shared queue.  Workers prefer higher
+        * priorities, but periodically look at lower priorities first so they cannot starve.
+        * Some workers may be reserved to run High priority jobs only.
+        *
+        * Workers may be pinned to processors and grouped per NUMA node, see SchedulerConfig.
+        *
+        * While profiling is enabled, every job records when it was queued, started and
+        * finished into a ring owned by the worker that ran it, and workers count steals, busy
+        * and idle time.  Profiling costs one relaxed load per job while disabled.
         */
         class HT_API Scheduler : public Singleton<Scheduler>
         {
@@ -79,20 +230,133 @@ namespace Hatchit
             Scheduler();
             ~Scheduler();
 
-            static void Initialize();
+            static void Initialize(uint32_t workerCount = 0, uint32_t highPriorityWorkers = 0);
+            static void Initialize(const SchedulerConfig& config);
+
+            template <class Func, class... Args,
+                class = typename std::enable_if<!std::is_same<typename std::decay<Func>::type, JobPriority>::value>::type>
+            static JobHandle ScheduleJob(Func&& function, Args&&... arguments);
 
             template <class Func, class... Args>
-            static void ScheduleJob(Func&& function, Args&&... arguments);
+            static JobHandle ScheduleJob(JobPriority priority, Func&& function, Args&&... arguments);
+
+            static JobHandle ScheduleGraph(JobGraph& graph, JobPriority priority = JobPriority::Normal);
+
+            template <class Func>
+            static void ParallelFor(size_t begin, size_t end, size_t grainSize, Func&& function);
+
+            template <class T, class Func, class Reduce>
+            static T ParallelReduce(size_t begin, size_t end, size_t grainSize, T identity, Func&& function, Reduce&& reduce);
 
             static void RunJobs();
 
+            static void WaitFor(const JobHandle& handle);
+
+            static uint32_t GetWorkerCount();
+
+            static void SetProfilingEnabled(bool enabled);
+            static bool IsProfilingEnabled();
+            static SchedulerStats GetStats();
+            static std::vector<JobEvent> GetJobEvents();
+            static bool ExportChromeTrace(const std::string& path);
+
         private:
-            uint32_t m_runningThreads;
-            uint32_t m_maxThreads;
-            std::queue<IJob*> m_jobs;
+            friend class Job;
+            friend class GraphJob;
+            friend class TaskDispatcher;
+
+            template <class Func, class... Args>
+            class BoundJob;
+
+            static const uint32_t PriorityCount = 3;
+
+            /**
+            \brief Number of jobs a worker takes between looking at lower priorities first.
+            **/
+            static const uint32_t StarvationInterval = 16;
+
+            /**
+            \brief Worker state, cache line aligned.  Before C++17 plain new ignores the alignment, so Worker brings its own allocator.
+            **/
+            struct alignas(64) Worker
+            {
+#if !defined(__cpp_aligned_new)
+                static void* operator new(size_t size);
+                static void operator delete(void* block);
+#endif
+
+                WorkStealingDeque<IJob*>    m_deques[PriorityCount];
+                std::thread                 m_thread;
+                uint32_t                    m_index;
+                uint32_t                    m_jobsTaken;
+                uint32_t                    m_node;
+                int32_t                     m_processor;
+                JobEventRing                m_events;
+                std::atomic<uint64_t>       m_jobsRun;
+                std::atomic<uint64_t>       m_steals;
+                std::atomic<uint64_t>       m_busyTime;
+                std::atomic<uint64_t>       m_idleTime;
+                bool                        m_highPriorityOnly;
+            };
+
+            struct ReadyQueue
+            {
+                std::vector<IJob*>  m_jobs;
+                size_t              m_head;
+
+                void Push(IJob* job);
+                IJob* Pop();
+            };
+
+            std::vector<std::unique_ptr<Worker>>    m_workers;
+            std::vector<std::vector<uint32_t>>      m_nodeWorkers;
+            bool                                    m_groupByNode;
+            std::vector<IJob*>                      m_jobs[PriorityCount];
+            ReadyQueue                              m_readyJobs[PriorityCount];
+            std::mutex                              m_mutex;
+            std::condition_variable                 m_condition;
+            std::condition_variable                 m_highPriorityCondition;
+            std::condition_variable                 m_waitCondition;
+            std::atomic<uint32_t>                   m_pendingJobs[PriorityCount];
+            std::atomic<uint32_t>                   m_sleepingWorkers;
+            std::atomic<uint32_t>                   m_sleepingHighPriorityWorkers;
+            std::atomic<uint32_t>                   m_waitingThreads;
+            std::atomic<uint32_t>                   m_peakPendingJobs[PriorityCount];
+            std::atomic<bool>                       m_profiling;
+            JobEventRing                            m_externalEvents;
+            bool                                    m_shutdown;
+
+            static void AddJob(IJob* job, JobPriority priority = JobPriority::Normal);
+            static void ReleaseJob(IJob* job);
+            static void ReleaseJob(IJob* job, JobPriority priority);
+            static JobPriority GetCurrentPriority();
+
+            template <class Func>
+            static JobHandle SpawnJob(Func&& function);
+
+            template <class Func>
+            static JobHandle SpawnJob(JobPriority priority, Func&& function);
+
+            template <class Func>
+            static void ParallelForRange(size_t begin, size_t end, size_t grainSize, Func& function);
+
+            template <class T, class Func, class Reduce>
+            static T ParallelReduceRange(size_t begin, size_t end, size_t grainSize, const T& identity, Func& function, Reduce& reduce);
+
+            static size_t ResolveGrainSize(size_t count, size_t grainSize);
+            static bool IsWorkerThread();
+            static bool ShouldSplit();
+            static JobHandle CreateHandle(uint32_t jobCount = 1);
+            static void CompleteJob(const JobHandle& handle);
 
-            static void AddJob(IJob* job);
-            static void ThreadEnded();
+            void WorkerMain(Worker* worker);
+            IJob* FindJob(Worker* worker, JobPriority& priority);
+            IJob* TakeJob(Worker* worker, uint32_t level);
+            IJob* StealJob(Worker* worker, uint32_t level);
+            void RunJob(IJob* job, JobPriority priority);
+            void RecordJob(const JobEvent& event);
+            void WakeWorkers(JobPriority priority, uint32_t jobCount);
+            bool HasPendingJobs(bool highPriorityOnly) const;
         };
     }
 }
@@ -0,0 +1,81 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+//Header includes
+#include <ht_platform.h> //HT_API
+#include <ht_noncopy.h> //INonCopy
+#include <cstddef> //size_t
+#include <mutex> //std::mutex
+#include <vector> //std::vector<T>
+#include <type_traits> //std::false_type
+
+//Inline includes
+#include <new> //operator new
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \struct UseSlabPool<T>
+        \ingroup HatchitCore
+        \brief Trait opting RefCounted type T into allocation from SlabPool<T>.
+
+        Specialize as std::true_type next to a resource type, i.e.
+        template<> struct UseSlabPool<Texture> : std::true_type {};
+        **/
+        template<typename T>
+        struct UseSlabPool : std::false_type {};
+
+        /**
+        \class SlabPool<T>
+        \ingroup HatchitCore
+        \brief Allocator for objects of type T, carved out of contiguous slabs.
+
+        Each slab holds ObjectsPerSlab objects.  Freed blocks go onto a free
+        list and are handed out again first, so allocating and freeing are
+        O(1) and objects of one type stay close together in memory.  Slabs
+        are retained for the lifetime of the process.
+        **/
+        template<typename T>
+        class HT_API SlabPool : public INonCopy
+        {
+        public:
+            static const size_t ObjectsPerSlab = 64;
+
+            static void* Allocate();
+            static void Free(void* block);
+
+        private:
+            union Slot
+            {
+                Slot*                       m_next;
+                alignas(T) unsigned char    m_storage[sizeof(T)];
+            };
+
+            struct Pool
+            {
+                std::mutex          m_mutex;
+                Slot*               m_free = nullptr;
+                std::vector<Slot*>  m_slabs;
+            };
+
+            static Pool& GetPool();
+        };
+    }
+}
+
+#include <ht_slabpool.inl>
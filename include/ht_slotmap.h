@@ -0,0 +1,128 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+//Header includes
+#include <ht_platform.h> //HT_API
+#include <stdint.h> //uint32_t
+#include <cstddef> //size_t
+#include <vector> //std::vector<T>
+#include <type_traits> //std::false_type
+
+//Inline includes
+#include <utility> //std::move, std::forward
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \struct SlotHandle
+        \ingroup HatchitCore
+        \brief Generational reference to an element of a SlotMap.
+
+        32 bit slot index plus the 32 bit generation of the slot when the
+        element was inserted.  Erasing the element bumps the generation, so
+        stale handles are detected instead of reaching a reused slot.  A
+        default constructed handle never refers to an element.
+        **/
+        struct HT_API SlotHandle
+        {
+            SlotHandle() : m_index(0), m_generation(0) {}
+            SlotHandle(uint32_t index, uint32_t generation) : m_index(index), m_generation(generation) {}
+
+            bool operator==(const SlotHandle& rhs) const { return m_index == rhs.m_index && m_generation == rhs.m_generation; }
+            bool operator!=(const SlotHandle& rhs) const { return !(*this == rhs); }
+
+            uint32_t    m_index;
+            uint32_t    m_generation;
+        };
+
+        /**
+        \struct UseSlotMap<T>
+        \ingroup HatchitCore
+        \brief Trait opting RefCounted type T into RefCountedResourceManager's per-type SlotMap.
+
+        Specialize as std::true_type next to a resource type, i.e.
+        template<> struct UseSlotMap<Texture> : std::true_type {};
+        **/
+        template<typename T>
+        struct UseSlotMap : std::false_type {};
+
+        /**
+        \class SlotMap<T>
+        \ingroup HatchitCore
+        \brief Densely packed container addressed by generational SlotHandles
+
+        Elements live contiguously and can be iterated linearly.  Erasing
+        moves the last element into the hole, so element addresses and
+        iteration order are not stable, but SlotHandles stay valid until
+        their element is erased.  Looking up a handle checks its generation
+        and costs two array accesses.  Not thread safe.
+        **/
+        template<typename T>
+        class HT_API SlotMap
+        {
+        public:
+            using iterator = typename std::vector<T>::iterator;
+            using const_iterator = typename std::vector<T>::const_iterator;
+
+            SlotMap();
+
+            SlotHandle insert(const T& _val);
+            SlotHandle insert(T&& _val);
+
+            template <class... Args>
+            SlotHandle emplace(Args&&... arguments);
+
+            bool erase(const SlotHandle& handle);
+            void clear();
+
+            T* get(const SlotHandle& handle);
+            const T* get(const SlotHandle& handle) const;
+            bool contains(const SlotHandle& handle) const;
+
+            iterator begin();
+            iterator end();
+            const_iterator begin() const;
+            const_iterator end() const;
+
+            size_t size() const;
+            bool empty() const;
+
+        private:
+            static const uint32_t NoSlot = 0xFFFFFFFF;
+
+            /**
+            \brief Index of the element while used, of the next free slot otherwise.
+            **/
+            struct Slot
+            {
+                uint32_t    m_index;
+                uint32_t    m_generation;
+            };
+
+            SlotHandle Allocate();
+            uint32_t Find(const SlotHandle& handle) const;
+
+            std::vector<T>          m_values;
+            std::vector<uint32_t>   m_valueSlots;
+            std::vector<Slot>       m_slots;
+            uint32_t                m_freeHead;
+        };
+    }
+}
+
+#include <ht_slotmap.inl>
@@ -0,0 +1,88 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+//Header includes
+#include <ht_platform.h> //HT_API
+#include <ht_noncopy.h> //INonCopy
+#include <cstddef> //size_t
+#include <atomic> //std::atomic<T>
+#include <memory> //std::unique_ptr<T>
+#include <type_traits> //std::aligned_storage<T>
+
+//Inline includes
+#include <new> //placement new
+#include <utility> //std::move
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \class SPSCQueue<T>
+        \ingroup HatchitCore
+        \brief Bounded lock-free single-producer single-consumer ring
+
+        Exactly one thread may push and exactly one other thread may pop.
+        The producer's and consumer's indices live on separate cache lines,
+        and each side keeps a private copy of the other side's index which
+        it only refreshes when the ring looks full or empty, so most
+        operations touch no shared cache line at all.  The batch functions
+        publish many elements with a single release store.
+        **/
+        template <typename T>
+        class HT_API SPSCQueue : public INonCopy
+        {
+        public:
+            explicit SPSCQueue(size_t capacity = 1024);
+            ~SPSCQueue();
+
+            bool try_push(const T& _val);
+            bool try_push(T&& _val);
+            bool try_pop(T& out);
+
+            size_t try_push_batch(T* values, size_t count);
+            size_t try_pop_batch(T* out, size_t count);
+
+            bool empty() const;
+            size_t size() const;
+            size_t capacity() const;
+
+        private:
+            using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+            template <class U>
+            bool Enqueue(U&& value);
+
+            size_t FreeSlots(size_t tail, size_t wanted);
+            size_t FilledSlots(size_t head, size_t wanted);
+
+            T* Slot(size_t index);
+
+            std::unique_ptr<Storage[]>      m_slots;
+            size_t                          m_mask;
+
+            //Written by the producer
+            alignas(64) std::atomic<size_t> m_tail;
+            size_t                          m_cachedHead;
+
+            //Written by the consumer
+            alignas(64) std::atomic<size_t> m_head;
+            size_t                          m_cachedTail;
+        };
+    }
+}
+
+#include <ht_spscqueue.inl>
@@ -0,0 +1,209 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+/** \file ht_task.h
+* Coroutine Tasks
+
+* This file contains the Task<T> coroutine type, whose continuations
+* resume on Scheduler workers.  It requires compiler support for C++20
+* coroutines and is empty otherwise.
+*/
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+//Header includes
+#include <ht_platform.h> //HT_API, BYTE
+#include <ht_scheduler.h> //Scheduler, JobHandle, JobPriority
+#include <coroutine> //std::coroutine_handle<T>
+#include <exception> //std::exception_ptr
+#include <optional> //std::optional<T>
+#include <string> //std::string
+#include <vector> //std::vector<T>
+
+//Inline includes
+#include <utility> //std::move, std::exchange
+
+/**
+\def HT_HAS_COROUTINES
+\brief Defined when Task<T> and ReadFileAsync are available.
+**/
+#define HT_HAS_COROUTINES
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        template <typename T>
+        class Task;
+
+        /**
+        \class TaskDispatcher
+        \ingroup HatchitCore
+        \brief Bridges coroutines and the Scheduler.
+
+        Resumes coroutines as jobs on the Scheduler's workers and tracks the
+        completion of started tasks.
+        **/
+        class HT_API TaskDispatcher
+        {
+        public:
+            static void Resume(std::coroutine_handle<> coroutine, JobPriority priority);
+
+            template <class Func>
+            static void Dispatch(JobPriority priority, Func&& function);
+
+            static JobPriority GetCurrentPriority();
+            static JobHandle CreateHandle();
+            static void Complete(const JobHandle& handle);
+        };
+
+        /**
+        \class TaskPromiseBase
+        \ingroup HatchitCore
+        \brief Promise state shared by every Task<T>.
+
+        Tasks start suspended.  When one finishes it transfers control to the
+        coroutine awaiting it, or signals the handle of a started task.
+        **/
+        class HT_API TaskPromiseBase
+        {
+        public:
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept { return false; }
+
+                template <class Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> coroutine) noexcept;
+
+                void await_resume() const noexcept {}
+            };
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+            void unhandled_exception() { m_exception = std::current_exception(); }
+
+            std::coroutine_handle<> m_continuation;
+            JobHandle               m_completion;
+            std::exception_ptr      m_exception;
+        };
+
+        /**
+        \class TaskPromise<T>
+        \ingroup HatchitCore
+        \brief Promise of a Task<T> producing a value.
+        **/
+        template <typename T>
+        class TaskPromise : public TaskPromiseBase
+        {
+        public:
+            Task<T> get_return_object();
+
+            template <typename U>
+            void return_value(U&& value);
+
+            T GetResult();
+
+        private:
+            std::optional<T> m_value;
+        };
+
+        /**
+        \class TaskPromise<void>
+        \ingroup HatchitCore
+        \brief Promise of a Task<void>.
+        **/
+        template <>
+        class TaskPromise<void> : public TaskPromiseBase
+        {
+        public:
+            Task<void> get_return_object();
+
+            void return_void() {}
+
+            void GetResult();
+        };
+
+        /**
+        \class Task<T>
+        \ingroup HatchitCore
+        \brief Lazily started coroutine producing a T.
+
+        A task does nothing until it is either awaited from another coroutine
+        with co_await, or started on the Scheduler with Start or Get.  A task
+        must not be both awaited and started.  When a task finishes, the
+        coroutine awaiting it resumes on the same worker thread.
+        **/
+        template <typename T = void>
+        class Task
+        {
+        public:
+            using promise_type = TaskPromise<T>;
+
+            Task(Task&& rhs) noexcept;
+            ~Task();
+
+            Task(const Task&) = delete;
+            Task& operator=(const Task&) = delete;
+            Task& operator=(Task&& rhs) noexcept;
+
+            bool await_ready() const noexcept;
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept;
+            T await_resume();
+
+            const JobHandle& Start(JobPriority priority = JobPriority::Normal);
+            T Get();
+
+            bool IsDone() const;
+
+        private:
+            friend class TaskPromise<T>;
+
+            explicit Task(std::coroutine_handle<promise_type> coroutine);
+
+            std::coroutine_handle<promise_type> m_coroutine;
+        };
+
+        /**
+        \class FileReadAwaiter
+        \ingroup HatchitCore
+        \brief Awaitable that reads a whole file on a Background job.
+
+        The awaiting coroutine is suspended while the file is read and then
+        resumed on a worker at its original priority.  Awaiting produces the
+        file contents, or rethrows the FileException raised while opening it.
+        **/
+        class HT_API FileReadAwaiter
+        {
+        public:
+            explicit FileReadAwaiter(std::string path);
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> coroutine);
+            std::vector<BYTE> await_resume();
+
+        private:
+            std::string         m_path;
+            std::vector<BYTE>   m_data;
+            std::exception_ptr  m_exception;
+        };
+
+        HT_API FileReadAwaiter ReadFileAsync(std::string path);
+    }
+}
+
+#include <ht_task.inl>
+
+#endif
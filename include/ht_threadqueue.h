@@ -21,6 +21,8 @@
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <vector>
+#include <chrono>
 
 namespace Hatchit
 {
@@ -30,6 +32,11 @@ namespace Hatchit
         \class ThreadsafeQueue<T>
         \ingroup HatchitCore
         \brief wrapper for std::queue that provides thread-safe functions
+
+        Elements are moved in and out of the queue.  The range and drain
+        functions transfer any number of elements under a single lock
+        acquisition, and waiting threads are notified after the lock has
+        been released.
         */
         template <typename T>
         class HT_API ThreadsafeQueue
@@ -43,11 +50,23 @@ namespace Hatchit
             ThreadsafeQueue& operator=(ThreadsafeQueue&& other);
 
             void push(T _val);
+            template <class InputIt>
+            void push_range(InputIt first, InputIt last);
+
             std::shared_ptr<T> wait_pop();
             void wait_pop(T& out);
+            bool try_pop(T& out);
+            template <class Rep, class Period>
+            bool wait_pop_for(T& out, const std::chrono::duration<Rep, Period>& timeout);
+
+            size_t drain(std::vector<T>& out);
+            size_t wait_drain(std::vector<T>& out);
+
             bool empty() const;
 
         private:
+            size_t MoveAll(std::vector<T>& out);
+
             std::queue<T>           m_data;
             mutable std::mutex      m_mutex;
             std::condition_variable m_condition;
@@ -0,0 +1,80 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+//Header includes
+#include <ht_platform.h> //HT_API
+#include <ht_noncopy.h> //INonCopy
+#include <stdint.h> //int64_t
+#include <cstddef> //size_t
+#include <atomic> //std::atomic<T>
+#include <vector> //std::vector<T>
+
+//Inline includes
+#include <type_traits> //std::is_trivially_copyable<T>
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \class WorkStealingDeque<T>
+        \ingroup HatchitCore
+        \brief Lock-free Chase-Lev work-stealing deque
+
+        The owning thread pushes and pops at the bottom of the deque while
+        any other thread may steal from the top.  T must be trivially copyable,
+        and is usually a pointer.  The internal buffer grows as needed; retired
+        buffers are kept alive until the deque is destroyed so concurrent
+        thieves never read freed memory.
+        **/
+        template <typename T>
+        class HT_API WorkStealingDeque : public INonCopy
+        {
+        public:
+            explicit WorkStealingDeque(int64_t capacity = 1024);
+            ~WorkStealingDeque();
+
+            void push(T _val);
+            bool pop(T& out);
+            bool steal(T& out);
+
+            bool empty() const;
+            size_t size() const;
+
+        private:
+            struct Buffer
+            {
+                Buffer(int64_t capacity);
+                ~Buffer();
+
+                T Get(int64_t index) const;
+                void Put(int64_t index, T value);
+                Buffer* Grow(int64_t bottom, int64_t top) const;
+
+                int64_t         m_capacity;
+                int64_t         m_mask;
+                std::atomic<T>* m_data;
+            };
+
+            alignas(64) std::atomic<int64_t>    m_top;
+            alignas(64) std::atomic<int64_t>    m_bottom;
+            std::atomic<Buffer*>                m_buffer;
+            std::vector<Buffer*>                m_retired;
+        };
+    }
+}
+
+#include <ht_workstealingdeque.inl>
@@ -0,0 +1,243 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_cputopology.h>
+
+#include <algorithm> //std::find
+#include <thread> //std::thread::hardware_concurrency
+#include <string> //std::string
+
+#ifdef HT_SYS_LINUX
+#include <fstream> //std::ifstream
+#include <cstdlib> //std::strtoul
+#include <dirent.h> //opendir, readdir
+#include <pthread.h> //pthread_setaffinity_np
+#include <sched.h> //cpu_set_t, sched_getaffinity
+#endif
+
+namespace Hatchit
+{
+    namespace Core
+    {
+#ifdef HT_SYS_LINUX
+        namespace
+        {
+            const char* const CpuPath = "/sys/devices/system/cpu/";
+
+            /**
+            \brief Reads first line of sysfs file at \a path into \a line.
+            **/
+            bool ReadLine(const std::string& path, std::string& line)
+            {
+                std::ifstream file(path);
+                return file.is_open() && static_cast<bool>(std::getline(file, line));
+            }
+
+            /**
+            \brief Reads unsigned value stored in sysfs file at \a path, or returns \a fallback.
+            **/
+            uint32_t ReadValue(const std::string& path, uint32_t fallback)
+            {
+                std::string line;
+                if (!ReadLine(path, line) || line.empty())
+                    return fallback;
+
+                return static_cast<uint32_t>(std::strtoul(line.c_str(), nullptr, 10));
+            }
+
+            /**
+            \brief Parses kernel cpu list such as "0-3,8,10-11".
+            **/
+            std::vector<uint32_t> ParseCpuList(const std::string& list)
+            {
+                std::vector<uint32_t> cpus;
+
+                const char* cursor = list.c_str();
+                while (*cursor)
+                {
+                    char* end = nullptr;
+                    unsigned long first = std::strtoul(cursor, &end, 10);
+                    if (end == cursor)
+                        break;
+
+                    unsigned long last = first;
+                    if (*end == '-')
+                    {
+                        cursor = end + 1;
+                        last = std::strtoul(cursor, &end, 10);
+                    }
+
+                    for (unsigned long cpu = first; cpu <= last; cpu++)
+                        cpus.push_back(static_cast<uint32_t>(cpu));
+
+                    cursor = *end == ',' ? end + 1 : end;
+                }
+
+                return cpus;
+            }
+
+            /**
+            \brief Returns NUMA node linked from sysfs directory of \a cpu, or 0.
+            **/
+            uint32_t ReadNode(uint32_t cpu)
+            {
+                std::string path = CpuPath + std::string("cpu") + std::to_string(cpu);
+
+                DIR* directory = opendir(path.c_str());
+                if (!directory)
+                    return 0;
+
+                uint32_t node = 0;
+                while (dirent* entry = readdir(directory))
+                {
+                    if (std::string(entry->d_name).compare(0, 4, "node") == 0)
+                    {
+                        node = static_cast<uint32_t>(std::strtoul(entry->d_name + 4, nullptr, 10));
+                        break;
+                    }
+                }
+
+                closedir(directory);
+                return node;
+            }
+        }
+#endif
+
+        /**
+        \fn CpuTopology::CpuTopology()
+        \brief Creates empty topology.
+        **/
+        CpuTopology::CpuTopology()
+            : m_processors()
+        {}
+
+        /**
+        \fn CpuTopology CpuTopology::Detect()
+        \brief Detects the logical processors the process may run on.
+
+        On Linux, reads the online processors from /sys/devices/system/cpu
+        and skips any excluded by the affinity mask of the process.
+        **/
+        CpuTopology CpuTopology::Detect()
+        {
+            CpuTopology topology;
+
+#ifdef HT_SYS_LINUX
+            std::string online;
+            if (ReadLine(CpuPath + std::string("online"), online))
+            {
+                cpu_set_t allowed;
+                CPU_ZERO(&allowed);
+                bool hasMask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+                for (uint32_t cpu : ParseCpuList(online))
+                {
+                    if (hasMask && cpu < CPU_SETSIZE && !CPU_ISSET(cpu, &allowed))
+                        continue;
+
+                    std::string path = CpuPath + std::string("cpu") + std::to_string(cpu) + "/topology/";
+
+                    Processor processor;
+                    processor.m_id = cpu;
+                    processor.m_core = ReadValue(path + "core_id", cpu);
+                    processor.m_package = ReadValue(path + "physical_package_id", 0);
+                    processor.m_node = ReadNode(cpu);
+                    topology.AddProcessor(processor);
+                }
+            }
+#endif
+
+            if (topology.IsEmpty())
+            {
+                uint32_t count = std::thread::hardware_concurrency();
+                for (uint32_t i = 0; i < count; i++)
+                    topology.AddProcessor({ i, i, 0, 0 });
+            }
+
+            return topology;
+        }
+
+        /**
+        \fn bool CpuTopology::PinCurrentThread(uint32_t processor)
+        \brief Restricts calling thread to logical \a processor.
+
+        Returns whether the thread was pinned.  Always fails on platforms
+        without thread affinity support.
+        **/
+        bool CpuTopology::PinCurrentThread(uint32_t processor)
+        {
+#if defined(HT_SYS_LINUX)
+            if (processor >= CPU_SETSIZE)
+                return false;
+
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(processor, &set);
+
+            return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#elif defined(HT_SYS_WINDOWS)
+            if (processor >= sizeof(DWORD_PTR) * 8)
+                return false;
+
+            return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << processor) != 0;
+#else
+            (void)processor;
+            return false;
+#endif
+        }
+
+        /**
+        \fn void CpuTopology::AddProcessor(const Processor& processor)
+        \brief Adds \a processor to the topology.
+        **/
+        void CpuTopology::AddProcessor(const Processor& processor)
+        {
+            m_processors.push_back(processor);
+        }
+
+        /**
+        \fn const std::vector<CpuTopology::Processor>& CpuTopology::GetProcessors() const
+        \brief Returns every logical processor in the topology.
+        **/
+        const std::vector<CpuTopology::Processor>& CpuTopology::GetProcessors() const
+        {
+            return m_processors;
+        }
+
+        /**
+        \fn std::vector<uint32_t> CpuTopology::GetNodes() const
+        \brief Returns the distinct NUMA nodes in order of first appearance.
+        **/
+        std::vector<uint32_t> CpuTopology::GetNodes() const
+        {
+            std::vector<uint32_t> nodes;
+            for (const Processor& processor : m_processors)
+            {
+                if (std::find(nodes.begin(), nodes.end(), processor.m_node) == nodes.end())
+                    nodes.push_back(processor.m_node);
+            }
+
+            return nodes;
+        }
+
+        /**
+        \fn bool CpuTopology::IsEmpty() const
+        \brief Returns whether the topology holds no processors.
+        **/
+        bool CpuTopology::IsEmpty() const
+        {
+            return m_processors.empty();
+        }
+    }
+}
@@ -167,13 +167,11 @@ namespace Hatchit {
             uint64_t firstHash = GetFnv1aHash(text.c_str(), half);
             uint64_t secondHash = GetFnv1aHash(text.c_str() + half, text.length() - half);
 
-            Guid guid;
-            memcpy(guid.m_uuid, &firstHash, 8);
-            memcpy(guid.m_uuid + 8, &secondHash, 8);
-            guid.m_hashCode = GetFnv1aHash(guid.m_uuid, 16);
-            guid.m_originalString = text;
+            uint8_t uuid[16];
+            memcpy(uuid, &firstHash, 8);
+            memcpy(uuid + 8, &secondHash, 8);
 
-            return guid;
+            return Guid(firstHash, secondHash, GetFnv1aHash(uuid, 16), text.c_str(), text.length());
         }
 
         /**
@@ -243,7 +241,8 @@ namespace Hatchit {
          * \brief Creates a new Guid.
          */
         Guid::Guid()
-            : m_hashCode(0)
+            : m_hashCode(0),
+            m_fromString(false)
         {
             // Generate the GUID bytes
             for (int index = 0; index < 16; ++index)
@@ -255,6 +254,48 @@ namespace Hatchit {
             m_hashCode = GetFnv1aHash(m_uuid, 16);
         }
 
+        /**
+         * \brief Creates the Guid Guid::FromString would return for the literal's text.
+         *
+         * Does not hash anything, and only copies the text in debug builds.
+         *
+         * \param literal The hashed text.
+         */
+        Guid::Guid(const GuidLiteral& literal)
+            : Guid(literal.m_first, literal.m_second, literal.m_hashCode, literal.m_text, literal.m_length)
+        {
+        }
+
+        /**
+         * \brief Creates a Guid from the hashes of a string.
+         *
+         * \param first The hash of the first half of the string.
+         * \param second The hash of the second half of the string.
+         * \param hashCode The hash of the resulting 16 bytes.
+         * \param text The string, kept in debug builds.
+         * \param length The length of the string.  Empty strings give an empty Guid.
+         */
+        Guid::Guid(uint64_t first, uint64_t second, uint64_t hashCode, const char* text, size_t length)
+            : m_hashCode(0),
+            m_fromString(false)
+        {
+            memset(m_uuid, 0, sizeof(m_uuid));
+            if (length == 0)
+            {
+                return;
+            }
+
+            memcpy(m_uuid, &first, 8);
+            memcpy(m_uuid + 8, &second, 8);
+            m_hashCode = hashCode;
+            m_fromString = true;
+#if defined(_DEBUG) || defined(DEBUG)
+            m_originalString.assign(text, length);
+#else
+            (void)text;
+#endif
+        }
+
         /**
          * \brief Copies one Guid's information into this Guid.
          *
@@ -301,11 +342,18 @@ namespace Hatchit {
         /**
          * \brief Gets this Guid's original string, if there is one.
          *
+         * Release builds do not keep the string, and return the textual
+         * representation of Guids created from strings instead.
+         *
          * \return The original string, if it exists.
          */
         std::string Guid::GetOriginalString() const
         {
+#if defined(_DEBUG) || defined(DEBUG)
             return m_originalString;
+#else
+            return m_fromString ? ToString() : std::string();
+#endif
         }
 
         /**
@@ -315,7 +363,7 @@ namespace Hatchit {
          */
         bool Guid::IsFromString() const
         {
-            return !m_originalString.empty();
+            return m_fromString;
         }
 
         /**
@@ -413,7 +461,10 @@ namespace Hatchit {
             m_hashCode = other.m_hashCode;
 
             // Copy original string
+            m_fromString = other.m_fromString;
+#if defined(_DEBUG) || defined(DEBUG)
             m_originalString = other.m_originalString;
+#endif
 
             return *this;
         }
@@ -437,8 +488,12 @@ namespace Hatchit {
             other.m_hashCode = 0;
 
             // Move original string
-            m_originalString = other.m_originalString;
+            m_fromString = other.m_fromString;
+            other.m_fromString = false;
+#if defined(_DEBUG) || defined(DEBUG)
+            m_originalString = std::move(other.m_originalString);
             other.m_originalString = "";
+#endif
 
             return *this;
         }
@@ -0,0 +1,254 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_hazardpointer.h>
+
+#include <mutex> //std::mutex, std::lock_guard<T>
+#include <vector> //std::vector<T>
+#include <algorithm> //std::sort, std::binary_search, std::max
+#include <cassert> //assert()
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        namespace
+        {
+            /**
+            \brief Minimum number of retired objects a thread collects before scanning.
+            **/
+            const size_t ScanThreshold = 64;
+
+            struct Retired
+            {
+                void*                   m_pointer;
+                HazardPointer::Deleter  m_deleter;
+            };
+
+            /**
+            \brief Hazard slots of one thread.  Records are reused by later threads.
+            **/
+            struct HazardRecord
+            {
+                std::atomic<void*>      m_slots[HazardPointer::SlotsPerThread];
+                std::atomic<bool>       m_active;
+                HazardRecord*           m_next;
+            };
+
+            /**
+            \brief Registry of every hazard record and of retired objects left by exited threads.
+
+            Allocated once and never destroyed, so threads may use it during
+            any thread or process shutdown.
+            **/
+            struct HazardRegistry
+            {
+                std::atomic<HazardRecord*>  m_records;
+                std::atomic<uint32_t>       m_recordCount;
+                std::mutex                  m_mutex;
+                std::vector<Retired>        m_orphans;
+
+                static HazardRegistry& Get()
+                {
+                    static HazardRegistry* _instance = new HazardRegistry();
+                    return *_instance;
+                }
+
+                HazardRegistry()
+                    : m_records(nullptr),
+                    m_recordCount(0)
+                {}
+
+                HazardRecord* Acquire()
+                {
+                    for (HazardRecord* record = m_records.load(std::memory_order_acquire); record; record = record->m_next)
+                    {
+                        bool active = false;
+                        if (!record->m_active.load(std::memory_order_relaxed) &&
+                            record->m_active.compare_exchange_strong(active, true, std::memory_order_acquire))
+                            return record;
+                    }
+
+                    HazardRecord* record = new HazardRecord();
+                    for (uint32_t i = 0; i < HazardPointer::SlotsPerThread; i++)
+                        record->m_slots[i].store(nullptr, std::memory_order_relaxed);
+                    record->m_active.store(true, std::memory_order_relaxed);
+
+                    HazardRecord* head = m_records.load(std::memory_order_relaxed);
+                    do
+                    {
+                        record->m_next = head;
+                    } while (!m_records.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+
+                    m_recordCount.fetch_add(1, std::memory_order_relaxed);
+                    return record;
+                }
+            };
+
+            /**
+            \brief Hazard record and retired objects of the calling thread.
+            **/
+            struct ThreadState
+            {
+                HazardRecord*           m_record = nullptr;
+                uint32_t                m_usedSlots = 0;
+                std::vector<Retired>    m_retired;
+
+                ~ThreadState()
+                {
+                    if (!m_record)
+                        return;
+
+                    Scan();
+
+                    if (!m_retired.empty())
+                    {
+                        HazardRegistry& registry = HazardRegistry::Get();
+                        std::lock_guard<std::mutex> lock(registry.m_mutex);
+                        registry.m_orphans.insert(registry.m_orphans.end(), m_retired.begin(), m_retired.end());
+                    }
+
+                    m_record->m_active.store(false, std::memory_order_release);
+                }
+
+                HazardRecord* Record()
+                {
+                    if (!m_record)
+                        m_record = HazardRegistry::Get().Acquire();
+
+                    return m_record;
+                }
+
+                void Scan()
+                {
+                    HazardRegistry& registry = HazardRegistry::Get();
+
+                    {
+                        //Adopt objects left behind by threads which have exited
+                        std::lock_guard<std::mutex> lock(registry.m_mutex);
+                        if (!registry.m_orphans.empty())
+                        {
+                            m_retired.insert(m_retired.end(), registry.m_orphans.begin(), registry.m_orphans.end());
+                            registry.m_orphans.clear();
+                        }
+                    }
+
+                    //Orders the unlinking of every retired object before reading the
+                    //hazard slots, pairing with the seq_cst publish in protect
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                    std::vector<void*> hazards;
+                    for (HazardRecord* record = registry.m_records.load(std::memory_order_acquire); record; record = record->m_next)
+                    {
+                        for (uint32_t i = 0; i < HazardPointer::SlotsPerThread; i++)
+                        {
+                            void* pointer = record->m_slots[i].load(std::memory_order_seq_cst);
+                            if (pointer)
+                                hazards.push_back(pointer);
+                        }
+                    }
+                    std::sort(hazards.begin(), hazards.end());
+
+                    //Deleters may retire further objects, so work on a detached list
+                    std::vector<Retired> retired;
+                    retired.swap(m_retired);
+
+                    for (const Retired& entry : retired)
+                    {
+                        if (std::binary_search(hazards.begin(), hazards.end(), entry.m_pointer))
+                            m_retired.push_back(entry);
+                        else
+                            entry.m_deleter(entry.m_pointer);
+                    }
+                }
+            };
+
+            thread_local ThreadState t_state;
+        }
+
+        /**
+        \fn HazardPointer::HazardPointer()
+        \brief Claims a free hazard slot of the calling thread.
+
+        A thread may hold at most SlotsPerThread hazard pointers at once.
+        **/
+        HazardPointer::HazardPointer()
+            : m_slot(nullptr)
+        {
+            HazardRecord* record = t_state.Record();
+            for (uint32_t i = 0; i < SlotsPerThread; i++)
+            {
+                if (!(t_state.m_usedSlots & (1U << i)))
+                {
+                    t_state.m_usedSlots |= 1U << i;
+                    m_slot = &record->m_slots[i];
+                    break;
+                }
+            }
+
+            assert(m_slot && "HazardPointer: too many hazard pointers on one thread");
+        }
+
+        /**
+        \fn HazardPointer::~HazardPointer()
+        \brief Clears the hazard and hands the slot back to the calling thread.
+
+        A HazardPointer must be destroyed on the thread which created it.
+        **/
+        HazardPointer::~HazardPointer()
+        {
+            reset();
+
+            uint32_t index = static_cast<uint32_t>(m_slot - &t_state.m_record->m_slots[0]);
+            t_state.m_usedSlots &= ~(1U << index);
+        }
+
+        /**
+        \fn void HazardPointer::reset()
+        \brief Stops protecting the last protected pointer.
+        **/
+        void HazardPointer::reset()
+        {
+            m_slot->store(nullptr, std::memory_order_release);
+        }
+
+        /**
+        \fn void HazardPointer::Retire(void* pointer, Deleter deleter)
+        \brief Calls \a deleter on \a pointer once no hazard pointer protects it.
+
+        \a pointer must already be unreachable from the shared data
+        structure.  Retired objects are scanned once the calling thread
+        holds more than a few per hazard slot in use across all threads.
+        **/
+        void HazardPointer::Retire(void* pointer, Deleter deleter)
+        {
+            t_state.Record();
+            t_state.m_retired.push_back({ pointer, deleter });
+
+            size_t threshold = HazardRegistry::Get().m_recordCount.load(std::memory_order_relaxed) * SlotsPerThread * 2;
+            if (t_state.m_retired.size() >= std::max(threshold, ScanThreshold))
+                t_state.Scan();
+        }
+
+        /**
+        \fn void HazardPointer::Scan()
+        \brief Deletes every object retired by the calling thread that is no longer protected.
+        **/
+        void HazardPointer::Scan()
+        {
+            t_state.Record();
+            t_state.Scan();
+        }
+    }
+}
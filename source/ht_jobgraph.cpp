@@ -0,0 +1,108 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_jobgraph.h>
+
+#include <cassert> //assert()
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \fn JobGraph::JobGraph()
+        \brief Creates empty job graph.
+        **/
+        JobGraph::JobGraph()
+            : m_nodes(),
+            m_remaining()
+        {}
+
+        /**
+        \fn JobGraph::~JobGraph()
+        \brief Releases job graph.
+        **/
+        JobGraph::~JobGraph() = default;
+
+        /**
+        \fn void JobGraph::AddDependency(NodeID predecessor, NodeID successor)
+        \brief Declares that \a successor may not start until \a predecessor has finished.
+        **/
+        void JobGraph::AddDependency(NodeID predecessor, NodeID successor)
+        {
+            assert(predecessor < m_nodes.size() && successor < m_nodes.size());
+
+            m_nodes[predecessor].m_successors.push_back(successor);
+            m_nodes[successor].m_predecessorCount++;
+        }
+
+        /**
+        \fn bool JobGraph::HasCycle() const
+        \brief Returns whether the dependencies contain a cycle.
+
+        Performs a topological sort of the graph.  Any node left unvisited
+        is part of, or depends on, a cycle.
+        **/
+        bool JobGraph::HasCycle() const
+        {
+            std::vector<uint32_t> remaining(m_nodes.size());
+            std::vector<NodeID> ready;
+            for (NodeID i = 0; i < m_nodes.size(); i++)
+            {
+                remaining[i] = m_nodes[i].m_predecessorCount;
+                if (remaining[i] == 0)
+                    ready.push_back(i);
+            }
+
+            size_t visited = 0;
+            while (!ready.empty())
+            {
+                NodeID node = ready.back();
+                ready.pop_back();
+                visited++;
+
+                for (NodeID successor : m_nodes[node].m_successors)
+                {
+                    if (--remaining[successor] == 0)
+                        ready.push_back(successor);
+                }
+            }
+
+            return visited != m_nodes.size();
+        }
+
+        /**
+        \fn size_t JobGraph::size() const
+        \brief Returns number of jobs in the graph.
+        **/
+        size_t JobGraph::size() const
+        {
+            return m_nodes.size();
+        }
+
+        /**
+        \fn JobGraph::NodeID JobGraph::AddNode(std::function<void()> function)
+        \brief Adds node running \a function with no dependencies.
+        **/
+        JobGraph::NodeID JobGraph::AddNode(std::function<void()> function)
+        {
+            Node node;
+            node.m_function = std::move(function);
+            node.m_predecessorCount = 0;
+            m_nodes.push_back(std::move(node));
+
+            return static_cast<NodeID>(m_nodes.size() - 1);
+        }
+    }
+}
@@ -0,0 +1,195 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_jobpool.h>
+
+#include <stdint.h> //uint32_t
+#include <mutex> //std::mutex, std::lock_guard<T>
+#include <vector> //std::vector<T>
+#include <new> //operator new
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        namespace
+        {
+            /**
+            \brief Number of blocks moved between a thread cache and the shared list at once.
+            **/
+            const uint32_t BatchSize = 64;
+
+            struct FreeBlock
+            {
+                FreeBlock* m_next;
+            };
+
+            /**
+            \brief List of free blocks handed between threads.  Holds at most BatchSize blocks.
+            **/
+            struct Batch
+            {
+                FreeBlock*  m_head;
+                uint32_t    m_count;
+            };
+
+            /**
+            \brief Shared list of full batches of free blocks.
+
+            Allocated once and never destroyed, so thread caches may return
+            blocks to it during any thread or process shutdown.
+            **/
+            struct SharedPool
+            {
+                std::mutex              m_mutex;
+                std::vector<Batch>      m_batches;
+
+                static SharedPool& Get()
+                {
+                    static SharedPool* _instance = new SharedPool();
+                    return *_instance;
+                }
+
+                Batch TakeBatch()
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        if (!m_batches.empty())
+                        {
+                            Batch batch = m_batches.back();
+                            m_batches.pop_back();
+                            return batch;
+                        }
+                    }
+
+                    //Carve a new batch out of one allocation
+                    unsigned char* chunk = static_cast<unsigned char*>(::operator new(JobPool::BlockSize * BatchSize));
+                    FreeBlock* head = nullptr;
+                    for (uint32_t i = BatchSize; i > 0; i--)
+                    {
+                        FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * JobPool::BlockSize);
+                        block->m_next = head;
+                        head = block;
+                    }
+
+                    Batch batch = { head, BatchSize };
+                    return batch;
+                }
+
+                void GiveBatch(Batch batch)
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_batches.push_back(batch);
+                }
+            };
+
+            /**
+            \brief Per-thread cache of free blocks.
+            **/
+            struct ThreadCache
+            {
+                FreeBlock*  m_head = nullptr;
+                uint32_t    m_count = 0;
+
+                ~ThreadCache()
+                {
+                    //Hand everything back in batch sized pieces
+                    while (m_count > 0)
+                    {
+                        FreeBlock* batch = m_head;
+                        FreeBlock* tail = m_head;
+                        uint32_t taken = 1;
+                        while (taken < BatchSize && tail->m_next)
+                        {
+                            tail = tail->m_next;
+                            taken++;
+                        }
+
+                        m_head = tail->m_next;
+                        m_count -= taken;
+                        tail->m_next = nullptr;
+
+                        //Partial batches keep their own count
+                        Batch partial = { batch, taken };
+                        SharedPool::Get().GiveBatch(partial);
+                    }
+                }
+            };
+
+            thread_local ThreadCache t_cache;
+        }
+
+        /**
+        \fn void* JobPool::Allocate(size_t size)
+        \brief Returns block of at least \a size bytes.
+        **/
+        void* JobPool::Allocate(size_t size)
+        {
+            if (size > BlockSize)
+                return ::operator new(size);
+
+            ThreadCache& cache = t_cache;
+            if (!cache.m_head)
+            {
+                Batch batch = SharedPool::Get().TakeBatch();
+                cache.m_head = batch.m_head;
+                cache.m_count = batch.m_count;
+            }
+
+            FreeBlock* block = cache.m_head;
+            cache.m_head = block->m_next;
+            cache.m_count--;
+
+            return block;
+        }
+
+        /**
+        \fn void JobPool::Free(void* block, size_t size)
+        \brief Returns \a block of \a size bytes obtained from Allocate.
+        **/
+        void JobPool::Free(void* block, size_t size)
+        {
+            if (!block)
+                return;
+
+            if (size > BlockSize)
+            {
+                ::operator delete(block);
+                return;
+            }
+
+            ThreadCache& cache = t_cache;
+            FreeBlock* freed = static_cast<FreeBlock*>(block);
+            freed->m_next = cache.m_head;
+            cache.m_head = freed;
+            cache.m_count++;
+
+            if (cache.m_count < BatchSize * 2)
+                return;
+
+            //Too many cached blocks, give a batch back to allocating threads
+            FreeBlock* batch = cache.m_head;
+            FreeBlock* tail = batch;
+            for (uint32_t i = 1; i < BatchSize; i++)
+                tail = tail->m_next;
+
+            cache.m_head = tail->m_next;
+            cache.m_count -= BatchSize;
+            tail->m_next = nullptr;
+
+            Batch full = { batch, BatchSize };
+            SharedPool::Get().GiveBatch(full);
+        }
+    }
+}
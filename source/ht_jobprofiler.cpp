@@ -0,0 +1,206 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_jobprofiler.h>
+
+#include <ht_scheduler.h> //JobPriority
+#include <ht_jsonhelper.h> //JSON
+#include <ht_file.h> //File
+#include <ht_file_exception.h> //FileException
+#include <ht_debug.h> //HT_ERROR_PRINTF
+#include <chrono> //std::chrono::steady_clock
+#include <set> //std::set<T>
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        namespace
+        {
+            const char* const PriorityNames[] = { "High", "Normal", "Background" };
+
+            /**
+            \brief Packs worker index and priority into one slot word.
+            **/
+            inline uint64_t PackSource(int32_t worker, JobPriority priority)
+            {
+                return (static_cast<uint64_t>(static_cast<uint32_t>(worker)) << 32) | static_cast<uint32_t>(priority);
+            }
+        }
+
+        /**
+        \fn JobEventRing::JobEventRing()
+        \brief Allocates Capacity empty slots.
+        **/
+        JobEventRing::JobEventRing()
+            : m_slots(new Slot[Capacity]),
+            m_next(0)
+        {
+            for (uint64_t i = 0; i < Capacity; i++)
+                m_slots[i].m_sequence.store(0, std::memory_order_relaxed);
+        }
+
+        /**
+        \fn void JobEventRing::Record(const JobEvent& event)
+        \brief Records \a event, overwriting the oldest event if the ring is full.
+
+        Safe to call from several threads, although every worker records
+        into its own ring.
+        **/
+        void JobEventRing::Record(const JobEvent& event)
+        {
+            uint64_t index = m_next.fetch_add(1, std::memory_order_relaxed);
+            Slot& slot = m_slots[index & (Capacity - 1)];
+
+            //Odd sequence marks the slot as being written
+            slot.m_sequence.store(index * 2 + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            slot.m_enqueueTime.store(event.m_enqueueTime, std::memory_order_relaxed);
+            slot.m_startTime.store(event.m_startTime, std::memory_order_relaxed);
+            slot.m_endTime.store(event.m_endTime, std::memory_order_relaxed);
+            slot.m_source.store(PackSource(event.m_worker, event.m_priority), std::memory_order_relaxed);
+
+            slot.m_sequence.store(index * 2 + 2, std::memory_order_release);
+        }
+
+        /**
+        \fn void JobEventRing::Collect(std::vector<JobEvent>& events) const
+        \brief Appends every complete event still held by the ring to \a events.
+        **/
+        void JobEventRing::Collect(std::vector<JobEvent>& events) const
+        {
+            uint64_t end = m_next.load(std::memory_order_acquire);
+            uint64_t begin = end > Capacity ? end - Capacity : 0;
+
+            for (uint64_t index = begin; index < end; index++)
+            {
+                const Slot& slot = m_slots[index & (Capacity - 1)];
+
+                uint64_t sequence = slot.m_sequence.load(std::memory_order_acquire);
+                if (sequence != index * 2 + 2)
+                    continue;
+
+                JobEvent event;
+                event.m_enqueueTime = slot.m_enqueueTime.load(std::memory_order_relaxed);
+                event.m_startTime = slot.m_startTime.load(std::memory_order_relaxed);
+                event.m_endTime = slot.m_endTime.load(std::memory_order_relaxed);
+
+                uint64_t source = slot.m_source.load(std::memory_order_relaxed);
+                event.m_worker = static_cast<int32_t>(static_cast<uint32_t>(source >> 32));
+                event.m_priority = static_cast<JobPriority>(static_cast<uint32_t>(source));
+
+                //Skip the event if a writer started on the slot while we read it
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.m_sequence.load(std::memory_order_relaxed) != sequence)
+                    continue;
+
+                events.push_back(event);
+            }
+        }
+
+        /**
+        \fn uint64_t JobEventRing::GetDroppedCount() const
+        \brief Returns number of events overwritten so far.
+        **/
+        uint64_t JobEventRing::GetDroppedCount() const
+        {
+            uint64_t recorded = m_next.load(std::memory_order_relaxed);
+            return recorded > Capacity ? recorded - Capacity : 0;
+        }
+
+        /**
+        \fn uint64_t JobProfiler::Now()
+        \brief Returns monotonic timestamp in nanoseconds.
+        **/
+        uint64_t JobProfiler::Now()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        /**
+        \fn std::string JobProfiler::ToChromeTrace(const std::vector<JobEvent>& events)
+        \brief Formats \a events as Chrome trace event JSON.
+
+        Every job becomes a complete event on the track of the worker that
+        ran it, with its queueing delay as an argument.  The result can be
+        loaded into chrome://tracing or Perfetto.
+        **/
+        std::string JobProfiler::ToChromeTrace(const std::vector<JobEvent>& events)
+        {
+            JSON trace;
+            JSON& traceEvents = trace["traceEvents"];
+            traceEvents = JSON::array();
+
+            std::set<int32_t> workers;
+            for (const JobEvent& event : events)
+            {
+                workers.insert(event.m_worker);
+
+                JSON entry;
+                entry["name"] = "Job";
+                entry["cat"] = PriorityNames[static_cast<uint32_t>(event.m_priority)];
+                entry["ph"] = "X";
+                entry["pid"] = 0;
+                entry["tid"] = event.m_worker;
+                entry["ts"] = static_cast<double>(event.m_startTime) / 1000.0;
+                entry["dur"] = static_cast<double>(event.m_endTime - event.m_startTime) / 1000.0;
+                entry["args"]["queued_us"] = static_cast<double>(event.m_startTime - event.m_enqueueTime) / 1000.0;
+                traceEvents.push_back(entry);
+            }
+
+            for (int32_t worker : workers)
+            {
+                JSON entry;
+                entry["name"] = "thread_name";
+                entry["ph"] = "M";
+                entry["pid"] = 0;
+                entry["tid"] = worker;
+                entry["args"]["name"] = worker >= 0 ? "Worker " + std::to_string(worker) : std::string("External");
+                traceEvents.push_back(entry);
+            }
+
+            trace["displayTimeUnit"] = "ns";
+
+            return trace.dump();
+        }
+
+        /**
+        \fn bool JobProfiler::ExportChromeTrace(const std::vector<JobEvent>& events, const std::string& path)
+        \brief Writes \a events as Chrome trace JSON to the file at \a path.
+
+        Returns whether the file was written.
+        **/
+        bool JobProfiler::ExportChromeTrace(const std::vector<JobEvent>& events, const std::string& path)
+        {
+            std::string trace = ToChromeTrace(events);
+
+            try
+            {
+                File file;
+                file.Open(path, File::FileMode::WriteText);
+                file.Write(reinterpret_cast<const BYTE*>(trace.data()), trace.size());
+                file.Close();
+            }
+            catch (const FileException& e)
+            {
+                HT_ERROR_PRINTF("JobProfiler::ExportChromeTrace: %s\n", e.what());
+                return false;
+            }
+
+            return true;
+        }
+    }
+}
@@ -14,10 +14,80 @@
 
 #include <ht_refcounted_resourcemanager.h>
 
+#include <vector> //std::vector<T>
+#include <utility> //std::swap
+
 namespace Hatchit
 {
     namespace Core
     {
+        namespace
+        {
+            struct RetiredResource
+            {
+                Guid            m_ID;
+            };
+
+            struct RetireList;
+
+            /**
+            \brief Registry of every thread's retire list, and of resources left by exited threads.
+
+            Allocated once and never destroyed, so threads may retire
+            resources during any thread or process shutdown.
+            **/
+            struct RetireRegistry
+            {
+                std::mutex                      m_mutex;
+                std::vector<RetireList*>        m_lists;
+                std::vector<RetiredResource>    m_orphans;
+
+                static RetireRegistry& Get()
+                {
+                    static RetireRegistry* _instance = new RetireRegistry();
+                    return *_instance;
+                }
+            };
+
+            /**
+            \brief Resources retired by one thread.
+
+            Only contended while FlushReleases collects it.
+            **/
+            struct RetireList
+            {
+                std::mutex                      m_mutex;
+                std::vector<RetiredResource>    m_resources;
+
+                RetireList()
+                {
+                    RetireRegistry& registry = RetireRegistry::Get();
+                    std::lock_guard<std::mutex> lock(registry.m_mutex);
+                    registry.m_lists.push_back(this);
+                }
+
+                ~RetireList()
+                {
+                    RetireRegistry& registry = RetireRegistry::Get();
+                    std::lock_guard<std::mutex> lock(registry.m_mutex);
+                    for (size_t i = 0; i < registry.m_lists.size(); i++)
+                    {
+                        if (registry.m_lists[i] == this)
+                        {
+                            registry.m_lists[i] = registry.m_lists.back();
+                            registry.m_lists.pop_back();
+                            break;
+                        }
+                    }
+
+                    for (RetiredResource& resource : m_resources)
+                        registry.m_orphans.push_back(std::move(resource));
+                }
+            };
+
+            thread_local RetireList t_retired;
+        }
+
         /**
         \fn RefCountedResourceManager& RefCountedResourceManager::GetInstance()
         \brief Returns singleton instance to RefCountedResourceManager.
@@ -29,5 +99,172 @@ namespace Hatchit
         {
             return RefCountedResourceManager::instance();
         }
+
+        /**
+        \fn RefCountedResourceManager::Shard& RefCountedResourceManager::GetShard(const Guid& ID)
+        \brief Returns shard responsible for resource with given ID.
+
+        Uses the top bits of the hash code, since the shard's own hash map
+        buckets on the low bits.
+        **/
+        RefCountedResourceManager::Shard& RefCountedResourceManager::GetShard(const Guid& ID)
+        {
+            uint64_t hash = ID.GetHashCode();
+            return GetInstance().m_shards[static_cast<uint32_t>(hash >> 58) % ShardCount];
+        }
+
+        /**
+        \fn void RefCountedResourceManager::SetDeferredRelease(bool deferred)
+        \brief Sets whether released resources are destroyed by FlushReleases.
+
+        Resources retired before deferred release is turned off are still
+        destroyed by the next FlushReleases.
+        **/
+        void RefCountedResourceManager::SetDeferredRelease(bool deferred)
+        {
+            GetInstance().m_deferredRelease.store(deferred, std::memory_order_relaxed);
+        }
+
+        /**
+        \fn bool RefCountedResourceManager::IsDeferredRelease()
+        \brief Returns whether released resources are destroyed by FlushReleases.
+        **/
+        bool RefCountedResourceManager::IsDeferredRelease()
+        {
+            return GetInstance().m_deferredRelease.load(std::memory_order_relaxed);
+        }
+
+        /**
+        \fn size_t RefCountedResourceManager::FlushReleases()
+        \brief Destroys every resource retired by any thread so far.
+
+        Resources referenced again since they were retired are kept.
+        Resources released by the destructors run here are retired for the
+        next flush.
+        \return Number of resources destroyed.
+        **/
+        size_t RefCountedResourceManager::FlushReleases()
+        {
+            std::vector<RetiredResource> retired;
+            {
+                RetireRegistry& registry = RetireRegistry::Get();
+                std::lock_guard<std::mutex> lock(registry.m_mutex);
+
+                std::swap(retired, registry.m_orphans);
+                for (RetireList* list : registry.m_lists)
+                {
+                    std::lock_guard<std::mutex> listLock(list->m_mutex);
+                    for (RetiredResource& resource : list->m_resources)
+                        retired.push_back(std::move(resource));
+                    list->m_resources.clear();
+                }
+            }
+
+            size_t released = 0;
+            for (const RetiredResource& resource : retired)
+            {
+                if (ReleaseRetired(resource.m_ID))
+                    released++;
+            }
+
+            return released;
+        }
+
+        /**
+        \fn void RefCountedResourceManager::Release(const Guid& ID)
+        \brief Drops last reference of resource with given ID, destroying it.
+
+        Drops a reference returned by GetRawPointer, or the last reference
+        of a handle.  The final decrement happens while the shard is locked,
+        so Find cannot hand out the resource as it is being destroyed.  A
+        resource found again in the meantime is kept.  The resource is
+        destroyed after its shard has been unlocked, so destructors may
+        release other resources.  In deferred release mode, the resource is
+        left for FlushReleases instead.
+        **/
+        void RefCountedResourceManager::Release(const Guid& ID)
+        {
+            Shard& shard = GetShard(ID);
+
+            RefCountedBase* resource = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(shard.m_mutex);
+
+                std::unordered_map<Guid, RefCountedBase*>::iterator it = shard.m_resources.find(ID);
+                if (it == shard.m_resources.end())
+                    return;
+
+                resource = it->second;
+                if (!resource->RemoveLastReference())
+                    return;
+
+                if (GetInstance().m_deferredRelease.load(std::memory_order_relaxed))
+                {
+                    //Retire while locked, a flush may destroy it once unlocked
+                    Retire(ID);
+                    return;
+                }
+
+                shard.m_resources.erase(it);
+                RemoveSlot(resource);
+            }
+
+            delete resource;
+        }
+
+        /**
+        \fn void RefCountedResourceManager::Retire(const Guid& ID)
+        \brief Queues resource with given ID on the calling thread's retire list.
+        **/
+        void RefCountedResourceManager::Retire(const Guid& ID)
+        {
+            RetireList& list = t_retired;
+            std::lock_guard<std::mutex> lock(list.m_mutex);
+            list.m_resources.push_back(RetiredResource{ ID });
+        }
+
+        /**
+        \fn bool RefCountedResourceManager::ReleaseRetired(const Guid& ID)
+        \brief Destroys retired resource with given ID unless it was referenced again.
+
+        A resource may be retired more than once if it was handed out and
+        released again before a flush.  Only a stored resource without
+        references is destroyed, so later entries for it find nothing.
+        **/
+        bool RefCountedResourceManager::ReleaseRetired(const Guid& ID)
+        {
+            Shard& shard = GetShard(ID);
+
+            RefCountedBase* resource = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(shard.m_mutex);
+
+                std::unordered_map<Guid, RefCountedBase*>::iterator it = shard.m_resources.find(ID);
+                if (it == shard.m_resources.end())
+                    return false;
+
+                resource = it->second;
+                if (resource->GetReferenceCount() != 0)
+                    return false;
+
+                shard.m_resources.erase(it);
+                RemoveSlot(resource);
+            }
+
+            delete resource;
+            return true;
+        }
+
+        /**
+        \fn void RefCountedResourceManager::RemoveSlot(RefCountedBase* resource)
+        \brief Removes \a resource from the SlotMap it was registered in, if any.
+
+        Called while the resource's shard is locked, before it is destroyed.
+        **/
+        void RefCountedResourceManager::RemoveSlot(RefCountedBase* resource)
+        {
+            if (resource->m_removeSlot)
+                resource->m_removeSlot(resource);
+        }
     }
-}
\ No newline at end of file
+}
@@ -15,6 +15,18 @@
 #include <ht_scheduler.h>
 
 #include <thread> //std::thread
+#include <functional> //std::hash<T>
+#include <algorithm> //std::stable_sort, std::sort, std::find
+#include <cassert> //assert()
+#include <exception> //std::exception
+#if !defined(__cpp_aligned_new)
+#include <cstdlib> //posix_memalign, free
+#include <new> //std::bad_alloc
+#if defined(HT_SYS_WINDOWS)
+#include <malloc.h> //_aligned_malloc, _aligned_free
+#endif
+#endif
+#include <ht_jobgraph.h> //JobGraph
 #include <ht_debug.h> //HT_DEBUG_PRINTF
 
 namespace Hatchit
@@ -22,20 +34,258 @@ namespace Hatchit
     namespace Core
     {
         /**
-        \fn Job::Job(std::function<void()> function)
-        \brief Creates Threading job for given function
+        \fn JobHandle::JobHandle()
+        \brief Creates an invalid handle which is always complete.
         **/
-        Job::Job(std::function<void()> function)
-            : m_function(std::move(function))
+        JobHandle::JobHandle()
+            : m_counter(nullptr)
         {}
 
         /**
-        \fn std::thread Job::GetThread()
-        \brief Creates thread for job and returns created thread.
+        \fn JobHandle::JobHandle(const JobHandle& rhs)
+        \brief Shares completion counter of \a rhs.
         **/
-        std::thread Job::GetThread() 
+        JobHandle::JobHandle(const JobHandle& rhs)
+            : m_counter(rhs.m_counter)
         {
-            return std::thread(m_function);
+            if (m_counter)
+                m_counter->m_references.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+        \fn JobHandle::JobHandle(JobHandle&& rhs)
+        \brief Takes completion counter from \a rhs, leaving it invalid.
+        **/
+        JobHandle::JobHandle(JobHandle&& rhs)
+            : m_counter(rhs.m_counter)
+        {
+            rhs.m_counter = nullptr;
+        }
+
+        /**
+        \fn JobHandle::JobHandle(Counter* counter)
+        \brief Adopts freshly created \a counter.
+        **/
+        JobHandle::JobHandle(Counter* counter)
+            : m_counter(counter)
+        {}
+
+        /**
+        \fn JobHandle::~JobHandle()
+        \brief Releases reference to completion counter.
+        **/
+        JobHandle::~JobHandle()
+        {
+            if (m_counter && m_counter->m_references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete m_counter;
+        }
+
+        /**
+        \fn JobHandle& JobHandle::operator=(const JobHandle& rhs)
+        \brief Shares completion counter of \a rhs.
+        **/
+        JobHandle& JobHandle::operator=(const JobHandle& rhs)
+        {
+            JobHandle copy(rhs);
+            std::swap(m_counter, copy.m_counter);
+
+            return *this;
+        }
+
+        /**
+        \fn JobHandle& JobHandle::operator=(JobHandle&& rhs)
+        \brief Takes completion counter from \a rhs, leaving it invalid.
+        **/
+        JobHandle& JobHandle::operator=(JobHandle&& rhs)
+        {
+            JobHandle moved(std::move(rhs));
+            std::swap(m_counter, moved.m_counter);
+
+            return *this;
+        }
+
+        /**
+        \fn bool JobHandle::IsValid() const
+        \brief Returns whether handle refers to a scheduled job.
+        **/
+        bool JobHandle::IsValid() const
+        {
+            return m_counter != nullptr;
+        }
+
+        /**
+        \fn bool JobHandle::IsComplete() const
+        \brief Returns whether referenced job has finished running.
+
+        Invalid handles are always complete.
+        **/
+        bool JobHandle::IsComplete() const
+        {
+            return !m_counter || m_counter->m_remaining.load(std::memory_order_acquire) == 0;
+        }
+
+        static_assert(sizeof(Job) <= JobPool::BlockSize, "Job must fit in a JobPool block");
+
+        /**
+        \fn void* IJob::operator new(size_t size)
+        \brief Allocates job from the job pool.
+        **/
+        void* IJob::operator new(size_t size)
+        {
+            return JobPool::Allocate(size);
+        }
+
+        /**
+        \fn void IJob::operator delete(void* block, size_t size)
+        \brief Returns job to the job pool.
+        **/
+        void IJob::operator delete(void* block, size_t size)
+        {
+            JobPool::Free(block, size);
+        }
+
+        /**
+        \fn Job::~Job()
+        \brief Destroys stored function.
+        **/
+        Job::~Job()
+        {
+            m_destroy(m_callable, m_callable == static_cast<void*>(m_storage));
+        }
+
+        namespace
+        {
+            /**
+            \brief Logs the exception a job's function threw.  Must be called from a catch block.
+            **/
+            void ReportJobException()
+            {
+                try
+                {
+                    throw;
+                }
+                catch (const std::exception& e)
+                {
+                    HT_ERROR_PRINTF("Scheduler: Job threw an exception: %s\n", e.what());
+                }
+                catch (...)
+                {
+                    HT_ERROR_PRINTF("Scheduler: Job threw an unknown exception\n");
+                }
+            }
+        }
+
+        /**
+        \fn void Job::Run()
+        \brief Executes job's function on the calling thread.
+
+        An exception thrown by the function is logged and swallowed, so the
+        job still completes and the worker keeps running.
+        **/
+        void Job::Run()
+        {
+            try
+            {
+                m_invoke(m_callable);
+            }
+            catch (...)
+            {
+                ReportJobException();
+            }
+
+            Scheduler::CompleteJob(m_handle);
+        }
+
+        /**
+        \class GraphJob
+        \ingroup HatchitCore
+        \brief Runs a single node of a JobGraph.
+
+        Once the node has run, every successor whose last predecessor this
+        was is released to the workers immediately.  A node whose function
+        throws is logged and still counts as run.
+        **/
+        class GraphJob : public IJob
+        {
+        public:
+            GraphJob(JobGraph& graph, JobGraph::NodeID node, const JobHandle& handle)
+                : m_graph(graph),
+                m_node(node),
+                m_handle(handle)
+            {}
+
+            void Run() override
+            {
+                const JobGraph::Node& node = m_graph.m_nodes[m_node];
+                try
+                {
+                    node.m_function();
+                }
+                catch (...)
+                {
+                    ReportJobException();
+                }
+
+                //Successors are released at the priority this node is running at
+                for (JobGraph::NodeID successor : node.m_successors)
+                {
+                    if (m_graph.m_remaining[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        Scheduler::ReleaseJob(new GraphJob(m_graph, successor, m_handle));
+                }
+
+                Scheduler::CompleteJob(m_handle);
+            }
+
+        private:
+            JobGraph&           m_graph;
+            JobGraph::NodeID    m_node;
+            JobHandle           m_handle;
+        };
+
+        namespace
+        {
+            /**
+            \brief Index of the worker owning the calling thread, or -1 for
+            threads outside the pool.
+            **/
+            thread_local int32_t t_workerIndex = -1;
+
+            /**
+            \brief Priority of the job running on the calling thread.
+            **/
+            thread_local JobPriority t_priority = JobPriority::Normal;
+
+            /**
+            \brief Per-thread state used to pick steal victims.
+            **/
+            thread_local uint32_t t_seed = 0;
+
+            /**
+            \brief Number of jobs running on the calling thread, counting jobs run inside WaitFor.
+            **/
+            thread_local uint32_t t_runDepth = 0;
+
+            /**
+            \brief Adds \a value to a counter only ever written by one thread.
+            **/
+            inline void AddToCounter(std::atomic<uint64_t>& counter, uint64_t value)
+            {
+                counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+            }
+
+            /**
+            \brief Advances xorshift state and returns next random value.
+            **/
+            inline uint32_t NextRandom(uint32_t& state)
+            {
+                if (state == 0)
+                    state = static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1U;
+
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                return state;
+            }
         }
 
         /**
@@ -43,81 +293,925 @@ namespace Hatchit
         \brief Initializes scheduler to begin managing threads.
         **/
         Scheduler::Scheduler()
-            : m_runningThreads(0),
-            m_maxThreads(0)
-        {}
+            : m_workers(),
+            m_nodeWorkers(),
+            m_groupByNode(false),
+            m_mutex(),
+            m_condition(),
+            m_highPriorityCondition(),
+            m_waitCondition(),
+            m_sleepingWorkers(0),
+            m_sleepingHighPriorityWorkers(0),
+            m_waitingThreads(0),
+            m_profiling(false),
+            m_externalEvents(),
+            m_shutdown(false)
+        {
+            for (uint32_t i = 0; i < PriorityCount; i++)
+            {
+                m_readyJobs[i].m_head = 0;
+                m_pendingJobs[i].store(0, std::memory_order_relaxed);
+                m_peakPendingJobs[i].store(0, std::memory_order_relaxed);
+            }
+        }
 
         /**
         \fn Scheduler::~Scheduler()
         \brief Releases members of scheduler.
+
+        Signals all worker threads to finish any released jobs and joins them.
+        Jobs which were scheduled but never run are discarded.
+        **/
+        Scheduler::~Scheduler()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_shutdown = true;
+            }
+            m_condition.notify_all();
+            m_highPriorityCondition.notify_all();
+
+            for (std::unique_ptr<Worker>& worker : m_workers)
+                worker->m_thread.join();
+
+            for (uint32_t i = 0; i < PriorityCount; i++)
+            {
+                for (IJob* job : m_jobs[i])
+                    delete job;
+            }
+        }
+
+        /**
+        \fn SchedulerConfig::SchedulerConfig()
+        \brief Creates config for one unpinned worker per hardware thread.
+        **/
+        SchedulerConfig::SchedulerConfig()
+            : m_workerCount(0),
+            m_highPriorityWorkers(0),
+            m_pinWorkers(false),
+            m_groupByNode(false),
+            m_topology()
+        {}
+
+        /**
+        \fn void Scheduler::Initialize(uint32_t workerCount, uint32_t highPriorityWorkers)
+        \brief Initializes scheduler and spawns worker threads
+
+        Initializes scheduler and spawns \a workerCount worker threads.  A
+        count of zero spawns one worker per hardware thread.  The first
+        \a highPriorityWorkers workers are reserved for High priority jobs;
+        at least one worker is always left to run other priorities.  Calling
+        Initialize more than once has no effect.
         **/
-        Scheduler::~Scheduler() = default;
+        void Scheduler::Initialize(uint32_t workerCount, uint32_t highPriorityWorkers)
+        {
+            SchedulerConfig config;
+            config.m_workerCount = workerCount;
+            config.m_highPriorityWorkers = highPriorityWorkers;
+
+            Initialize(config);
+        }
 
         /**
-        \fn void Scheduler::Initialize()
-        \brief Initializes scheduler and sets max threads
+        \fn void Scheduler::Initialize(const SchedulerConfig& config)
+        \brief Initializes scheduler and spawns worker threads as described by \a config
 
-        Initializes scheduler and sets max threads to capacity of hardware.
+        A worker count of zero spawns one worker per processor in the
+        topology when pinning or grouping, otherwise one per hardware thread.
+        With more workers than processors, processors are reused in order.
+        Calling Initialize more than once has no effect.
         **/
-        void Scheduler::Initialize() 
+        void Scheduler::Initialize(const SchedulerConfig& config)
         {
             Scheduler& _instance = Scheduler::instance();
 
-            _instance.m_maxThreads = std::thread::hardware_concurrency();
+            std::lock_guard<std::mutex> lock(_instance.m_mutex);
+            if (!_instance.m_workers.empty())
+                return;
+
+            bool placed = config.m_pinWorkers || config.m_groupByNode;
+
+            std::vector<CpuTopology::Processor> processors;
+            if (placed)
+            {
+                processors = config.m_topology.IsEmpty() ? CpuTopology::Detect().GetProcessors() : config.m_topology.GetProcessors();
+
+                //Rank hyperthreads of the same core so every core gets a worker before any core gets two
+                std::vector<uint32_t> ranks(processors.size(), 0);
+                for (size_t i = 0; i < processors.size(); i++)
+                {
+                    for (size_t j = 0; j < i; j++)
+                    {
+                        if (processors[j].m_package == processors[i].m_package && processors[j].m_core == processors[i].m_core)
+                            ranks[i]++;
+                    }
+                }
+
+                std::vector<size_t> order(processors.size());
+                for (size_t i = 0; i < order.size(); i++)
+                    order[i] = i;
+
+                bool groupByNode = config.m_groupByNode;
+                std::stable_sort(order.begin(), order.end(), [&processors, &ranks, groupByNode](size_t lhs, size_t rhs) {
+                    if (groupByNode && processors[lhs].m_node != processors[rhs].m_node)
+                        return processors[lhs].m_node < processors[rhs].m_node;
+                    return ranks[lhs] < ranks[rhs];
+                });
+
+                std::vector<CpuTopology::Processor> sorted;
+                sorted.reserve(order.size());
+                for (size_t index : order)
+                    sorted.push_back(processors[index]);
+                processors.swap(sorted);
+            }
+
+            uint32_t workerCount = config.m_workerCount;
+            if (workerCount == 0)
+                workerCount = placed ? static_cast<uint32_t>(processors.size()) : std::thread::hardware_concurrency();
+            if (workerCount == 0)
+                workerCount = 1;
+
+            uint32_t highPriorityWorkers = config.m_highPriorityWorkers;
+            if (highPriorityWorkers >= workerCount)
+                highPriorityWorkers = workerCount - 1;
+
+            //All deques must exist before any worker starts stealing
+            std::vector<uint32_t> nodes;
+            _instance.m_workers.reserve(workerCount);
+            for (uint32_t i = 0; i < workerCount; i++)
+            {
+                std::unique_ptr<Worker> worker(new Worker());
+                worker->m_index = i;
+                worker->m_jobsTaken = 0;
+                worker->m_highPriorityOnly = i < highPriorityWorkers;
+                worker->m_node = 0;
+                worker->m_processor = -1;
+                worker->m_jobsRun.store(0, std::memory_order_relaxed);
+                worker->m_steals.store(0, std::memory_order_relaxed);
+                worker->m_busyTime.store(0, std::memory_order_relaxed);
+                worker->m_idleTime.store(0, std::memory_order_relaxed);
+
+                if (!processors.empty())
+                {
+                    const CpuTopology::Processor& processor = processors[i % processors.size()];
+                    if (config.m_pinWorkers)
+                        worker->m_processor = static_cast<int32_t>(processor.m_id);
+
+                    //Store nodes as dense indices into m_nodeWorkers
+                    std::vector<uint32_t>::iterator node = std::find(nodes.begin(), nodes.end(), processor.m_node);
+                    worker->m_node = static_cast<uint32_t>(node - nodes.begin());
+                    if (node == nodes.end())
+                        nodes.push_back(processor.m_node);
+                }
+
+                _instance.m_workers.push_back(std::move(worker));
+            }
+
+            _instance.m_groupByNode = config.m_groupByNode && nodes.size() > 1;
+            _instance.m_nodeWorkers.assign(nodes.empty() ? 1 : nodes.size(), std::vector<uint32_t>());
+            for (std::unique_ptr<Worker>& worker : _instance.m_workers)
+                _instance.m_nodeWorkers[worker->m_node].push_back(worker->m_index);
+
+            for (std::unique_ptr<Worker>& worker : _instance.m_workers)
+                worker->m_thread = std::thread(&Scheduler::WorkerMain, &_instance, worker.get());
+
+            HT_DEBUG_PRINTF("Scheduler started %u worker threads on %u nodes, %u reserved for high priority\n",
+                workerCount, static_cast<uint32_t>(_instance.m_nodeWorkers.size()), highPriorityWorkers);
+        }
+
+        /**
+        \fn JobHandle Scheduler::ScheduleGraph(JobGraph& graph, JobPriority priority)
+        \brief Schedules every job in \a graph respecting its dependencies.
+
+        Jobs without predecessors are scheduled like ScheduleJob and start
+        on the next RunJobs or WaitFor.  Every other job is released the
+        moment its last predecessor finishes.  The returned handle completes
+        once all jobs in the graph have run.  A graph containing a cycle is
+        not scheduled: the error is logged, debug builds assert, and an
+        invalid handle, which is always complete, is returned.
+        **/
+        JobHandle Scheduler::ScheduleGraph(JobGraph& graph, JobPriority priority)
+        {
+            if (graph.m_nodes.empty())
+                return JobHandle();
+
+            //Nodes on or behind a cycle would never run, and the handle never complete
+            if (graph.HasCycle())
+            {
+                HT_ERROR_PRINTF("Scheduler::ScheduleGraph: Job graph contains a cycle\n");
+                assert(false);
+                return JobHandle();
+            }
+
+            size_t nodeCount = graph.m_nodes.size();
+            graph.m_remaining.reset(new std::atomic<uint32_t>[nodeCount]);
+            for (size_t i = 0; i < nodeCount; i++)
+                graph.m_remaining[i].store(graph.m_nodes[i].m_predecessorCount, std::memory_order_relaxed);
+
+            JobHandle handle = CreateHandle(static_cast<uint32_t>(nodeCount));
+            for (size_t i = 0; i < nodeCount; i++)
+            {
+                if (graph.m_nodes[i].m_predecessorCount == 0)
+                    AddJob(new GraphJob(graph, static_cast<JobGraph::NodeID>(i), handle), priority);
+            }
+
+            return handle;
         }
 
         /**
         \fn void Scheduler::RunJobs()
-        \brief Begins running jobs in a threaded environment
+        \brief Releases scheduled jobs to the worker threads
 
-        Will attempt to run jobs in a threaded environment.  May hang until
-        all jobs begin running.
+        Releases every job scheduled so far to the worker pool and wakes
+        sleeping workers.  Does not wait for the jobs to start or finish.
+        If the scheduler has not been initialized, it is initialized here.
         **/
         void Scheduler::RunJobs()
         {
             Scheduler& _instance = Scheduler::instance();
 
-            _instance.m_runningThreads = 0;
-            while (_instance.m_jobs.size() > 0)
+            if (_instance.m_workers.empty())
+                Initialize();
+
+            uint32_t released[PriorityCount];
+            {
+                std::lock_guard<std::mutex> lock(_instance.m_mutex);
+                for (uint32_t i = 0; i < PriorityCount; i++)
+                {
+                    std::vector<IJob*>& jobs = _instance.m_jobs[i];
+                    released[i] = static_cast<uint32_t>(jobs.size());
+
+                    //Both vectors keep their capacity, so steady state submission does not allocate
+                    ReadyQueue& ready = _instance.m_readyJobs[i];
+                    ready.m_jobs.insert(ready.m_jobs.end(), jobs.begin(), jobs.end());
+                    jobs.clear();
+                }
+            }
+
+            for (uint32_t i = 0; i < PriorityCount; i++)
+            {
+                if (released[i] > 0)
+                    _instance.WakeWorkers(static_cast<JobPriority>(i), released[i]);
+            }
+        }
+
+        /**
+        \fn void Scheduler::WaitFor(const JobHandle& handle)
+        \brief Blocks until the job referenced by \a handle has finished.
+
+        Releases any scheduled jobs, then runs other pending jobs on the
+        calling thread until the awaited job completes.  The calling thread
+        only sleeps while there is nothing else to run.
+        **/
+        void Scheduler::WaitFor(const JobHandle& handle)
+        {
+            if (handle.IsComplete())
+                return;
+
+            Scheduler& _instance = Scheduler::instance();
+
+            Worker* worker = nullptr;
+            if (t_workerIndex >= 0)
+                worker = _instance.m_workers[t_workerIndex].get();
+            else
+                RunJobs();
+
+            //Reserved workers can only help with High priority jobs
+            bool highPriorityOnly = worker && worker->m_highPriorityOnly;
+
+            while (!handle.IsComplete())
             {
-                if (_instance.m_runningThreads == _instance.m_maxThreads)
+                JobPriority priority;
+                IJob* job = _instance.FindJob(worker, priority);
+                if (job)
+                {
+                    _instance.RunJob(job, priority);
                     continue;
+                }
 
-                _instance.m_runningThreads++;
-                HT_DEBUG_PRINTF("Running Threads - %u : ", _instance.m_runningThreads);
+                _instance.m_waitingThreads.fetch_add(1, std::memory_order_seq_cst);
+                {
+                    std::unique_lock<std::mutex> lock(_instance.m_mutex);
+                    _instance.m_waitCondition.wait(lock, [&_instance, &handle, highPriorityOnly] {
+                        return handle.IsComplete() || _instance.HasPendingJobs(highPriorityOnly);
+                    });
+                }
+                _instance.m_waitingThreads.fetch_sub(1, std::memory_order_seq_cst);
+            }
+        }
 
-                //Get the next job's pointer and then pop it off
-                IJob* nextJob = _instance.m_jobs.front();
-                _instance.m_jobs.pop();
+        /**
+        \fn uint32_t Scheduler::GetWorkerCount()
+        \brief Returns number of worker threads, initializing the scheduler if needed.
+        **/
+        uint32_t Scheduler::GetWorkerCount()
+        {
+            Scheduler& _instance = Scheduler::instance();
+
+            if (_instance.m_workers.empty())
+                Initialize();
 
-                std::thread jobThread = nextJob->GetThread();
-                jobThread.detach();
+            return static_cast<uint32_t>(_instance.m_workers.size());
+        }
+
+        /**
+        \fn void Scheduler::SetProfilingEnabled(bool enabled)
+        \brief Starts or stops recording job timings and worker counters.
 
-                //Job has been scheduled, we can delete it
-                delete nextJob;
+        Jobs queued before profiling was enabled report their start time as
+        their enqueue time.  Recorded data is kept when profiling stops.
+        **/
+        void Scheduler::SetProfilingEnabled(bool enabled)
+        {
+            Scheduler::instance().m_profiling.store(enabled, std::memory_order_relaxed);
+        }
+
+        /**
+        \fn bool Scheduler::IsProfilingEnabled()
+        \brief Returns whether job timings and worker counters are being recorded.
+        **/
+        bool Scheduler::IsProfilingEnabled()
+        {
+            return Scheduler::instance().m_profiling.load(std::memory_order_relaxed);
+        }
+
+        /**
+        \fn SchedulerStats Scheduler::GetStats()
+        \brief Returns snapshot of the worker counters and queue depths.
+
+        Counters only advance while profiling is enabled, queue depths are
+        always current.  Safe to call while jobs are running.
+        **/
+        SchedulerStats Scheduler::GetStats()
+        {
+            Scheduler& _instance = Scheduler::instance();
+
+            SchedulerStats stats;
+            stats.m_droppedEvents = _instance.m_externalEvents.GetDroppedCount();
+
+            for (const std::unique_ptr<Worker>& worker : _instance.m_workers)
+            {
+                WorkerStats workerStats;
+                workerStats.m_jobsRun = worker->m_jobsRun.load(std::memory_order_relaxed);
+                workerStats.m_steals = worker->m_steals.load(std::memory_order_relaxed);
+                workerStats.m_busyTime = worker->m_busyTime.load(std::memory_order_relaxed);
+                workerStats.m_idleTime = worker->m_idleTime.load(std::memory_order_relaxed);
+                stats.m_workers.push_back(workerStats);
+
+                stats.m_droppedEvents += worker->m_events.GetDroppedCount();
+            }
+
+            std::lock_guard<std::mutex> lock(_instance.m_mutex);
+            for (uint32_t i = 0; i < PriorityCount; i++)
+            {
+                uint32_t staged = static_cast<uint32_t>(_instance.m_jobs[i].size());
+                stats.m_queueDepth.push_back(_instance.m_pendingJobs[i].load(std::memory_order_relaxed) + staged);
+                stats.m_peakQueueDepth.push_back(_instance.m_peakPendingJobs[i].load(std::memory_order_relaxed));
             }
+
+            return stats;
+        }
+
+        /**
+        \fn std::vector<JobEvent> Scheduler::GetJobEvents()
+        \brief Returns the most recent job timings of every worker, ordered by start time.
+
+        Each worker keeps its last JobEventRing::Capacity events.  Safe to
+        call while jobs are running.
+        **/
+        std::vector<JobEvent> Scheduler::GetJobEvents()
+        {
+            Scheduler& _instance = Scheduler::instance();
+
+            std::vector<JobEvent> events;
+            for (const std::unique_ptr<Worker>& worker : _instance.m_workers)
+                worker->m_events.Collect(events);
+            _instance.m_externalEvents.Collect(events);
+
+            std::sort(events.begin(), events.end(), [](const JobEvent& lhs, const JobEvent& rhs) {
+                return lhs.m_startTime < rhs.m_startTime;
+            });
+
+            return events;
+        }
+
+        /**
+        \fn bool Scheduler::ExportChromeTrace(const std::string& path)
+        \brief Writes recorded job timings as Chrome trace JSON to \a path.
+
+        Returns whether the file was written.
+        **/
+        bool Scheduler::ExportChromeTrace(const std::string& path)
+        {
+            return JobProfiler::ExportChromeTrace(GetJobEvents(), path);
+        }
+
+        /**
+        \fn size_t Scheduler::ResolveGrainSize(size_t count, size_t grainSize)
+        \brief Returns \a grainSize, or a default for \a count indices if it is zero.
+
+        The default gives each worker around eight pieces to balance load.
+        **/
+        size_t Scheduler::ResolveGrainSize(size_t count, size_t grainSize)
+        {
+            if (grainSize > 0)
+                return grainSize;
+
+            size_t pieces = static_cast<size_t>(GetWorkerCount()) * 8;
+            grainSize = count / pieces;
+
+            return grainSize > 0 ? grainSize : 1;
+        }
+
+        /**
+        \fn bool Scheduler::IsWorkerThread()
+        \brief Returns whether the calling thread belongs to the worker pool.
+        **/
+        bool Scheduler::IsWorkerThread()
+        {
+            return t_workerIndex >= 0;
         }
 
         /**
-        \fn void Scheduler::AddJob(IJob* job)
+        \fn bool Scheduler::ShouldSplit()
+        \brief Returns whether the calling thread should split off more work.
+
+        Workers only split while their own deque is empty, meaning earlier
+        splits have been stolen or run.  Threads outside the pool never split,
+        so helping from WaitFor cannot nest arbitrarily deep.
+        **/
+        bool Scheduler::ShouldSplit()
+        {
+            if (t_workerIndex < 0)
+                return false;
+
+            Worker* worker = Scheduler::instance().m_workers[t_workerIndex].get();
+            return worker->m_deques[static_cast<uint32_t>(t_priority)].empty();
+        }
+
+        /**
+        \fn void Scheduler::AddJob(IJob* job, JobPriority priority)
         \brief Adds a job to run in threaded environment.
+
+        Jobs added from a worker thread go straight onto that worker's deque.
+        Jobs added from any other thread wait for the next call to RunJobs.
+        **/
+        void Scheduler::AddJob(IJob* job, JobPriority priority)
+        {
+            Scheduler& _instance = Scheduler::instance();
+            uint32_t level = static_cast<uint32_t>(priority);
+
+            if (_instance.m_profiling.load(std::memory_order_relaxed))
+                job->m_enqueueTime = JobProfiler::Now();
+
+            if (t_workerIndex >= 0)
+            {
+                _instance.m_workers[t_workerIndex]->m_deques[level].push(job);
+                _instance.WakeWorkers(priority, 1);
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(_instance.m_mutex);
+            _instance.m_jobs[level].push_back(job);
+        }
+
+        /**
+        \fn void Scheduler::ReleaseJob(IJob* job)
+        \brief Hands \a job straight to the workers without waiting for RunJobs.
+
+        The job gets the priority of the job running on the calling thread.
+        **/
+        void Scheduler::ReleaseJob(IJob* job)
+        {
+            ReleaseJob(job, t_priority);
+        }
+
+        /**
+        \fn void Scheduler::ReleaseJob(IJob* job, JobPriority priority)
+        \brief Hands \a job with \a priority straight to the workers without waiting for RunJobs.
         **/
-        void Scheduler::AddJob(IJob* job)
+        void Scheduler::ReleaseJob(IJob* job, JobPriority priority)
         {
             Scheduler& _instance = Scheduler::instance();
+            uint32_t level = static_cast<uint32_t>(priority);
 
-            _instance.m_jobs.push(job);
+            if (_instance.m_profiling.load(std::memory_order_relaxed))
+                job->m_enqueueTime = JobProfiler::Now();
+
+            if (t_workerIndex >= 0)
+            {
+                _instance.m_workers[t_workerIndex]->m_deques[level].push(job);
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lock(_instance.m_mutex);
+                _instance.m_readyJobs[level].Push(job);
+            }
+
+            _instance.WakeWorkers(priority, 1);
+        }
+
+        /**
+        \fn JobPriority Scheduler::GetCurrentPriority()
+        \brief Returns priority of the job running on the calling thread, or Normal.
+        **/
+        JobPriority Scheduler::GetCurrentPriority()
+        {
+            return t_priority;
+        }
+
+        /**
+        \fn JobHandle Scheduler::CreateHandle(uint32_t jobCount)
+        \brief Creates handle to a new counter awaiting \a jobCount jobs.
+        **/
+        JobHandle Scheduler::CreateHandle(uint32_t jobCount)
+        {
+            JobHandle::Counter* counter = new JobHandle::Counter();
+            counter->m_remaining.store(jobCount, std::memory_order_relaxed);
+            counter->m_references.store(1, std::memory_order_relaxed);
+
+            return JobHandle(counter);
         }
 
         /**
-        \fn void Scheduler::ThreadEnded()
-        \brief Function called once a thread ends to decrease running total.
+        \fn void Scheduler::CompleteJob(const JobHandle& handle)
+        \brief Signals that a job counted by \a handle has finished.
+
+        Wakes threads blocked in WaitFor once the counter reaches zero.
         **/
-        void Scheduler::ThreadEnded() 
+        void Scheduler::CompleteJob(const JobHandle& handle)
         {
+            if (!handle.m_counter)
+                return;
+
+            if (handle.m_counter->m_remaining.fetch_sub(1, std::memory_order_seq_cst) != 1)
+                return;
+
             Scheduler& _instance = Scheduler::instance();
+            if (_instance.m_waitingThreads.load(std::memory_order_seq_cst) == 0)
+                return;
+
+            {
+                std::lock_guard<std::mutex> lock(_instance.m_mutex);
+            }
+            _instance.m_waitCondition.notify_all();
+        }
+
+        /**
+        \fn void Scheduler::WakeWorkers(JobPriority priority, uint32_t jobCount)
+        \brief Publishes \a jobCount new jobs of \a priority and wakes sleeping threads.
+
+        The pending count is raised before sleeping workers are checked, and
+        workers register as sleeping before checking the pending count, so a
+        wakeup is never lost.  High priority jobs wake the reserved workers
+        that are asleep first, and normal workers for the jobs left over.
+        **/
+        void Scheduler::WakeWorkers(JobPriority priority, uint32_t jobCount)
+        {
+            uint32_t level = static_cast<uint32_t>(priority);
+            uint32_t pending = m_pendingJobs[level].fetch_add(jobCount, std::memory_order_seq_cst) + jobCount;
+
+            if (m_profiling.load(std::memory_order_relaxed))
+            {
+                uint32_t peak = m_peakPendingJobs[level].load(std::memory_order_relaxed);
+                while (pending > peak && !m_peakPendingJobs[level].compare_exchange_weak(peak, pending, std::memory_order_relaxed))
+                {
+                }
+            }
+
+            uint32_t reservedJobs = 0;
+            if (priority == JobPriority::High)
+                reservedJobs = std::min(jobCount, m_sleepingHighPriorityWorkers.load(std::memory_order_seq_cst));
+
+            uint32_t leftoverJobs = jobCount - reservedJobs;
+            bool sleeping = leftoverJobs > 0 && m_sleepingWorkers.load(std::memory_order_seq_cst) > 0;
+            bool waiting = m_waitingThreads.load(std::memory_order_seq_cst) > 0;
+            if (reservedJobs == 0 && !sleeping && !waiting)
+                return;
+
+            {
+                //Serialize with threads between their check and their wait
+                std::lock_guard<std::mutex> lock(m_mutex);
+            }
+
+            if (reservedJobs == 1)
+                m_highPriorityCondition.notify_one();
+            else if (reservedJobs > 1)
+                m_highPriorityCondition.notify_all();
+
+            if (sleeping && leftoverJobs == 1)
+                m_condition.notify_one();
+            else if (sleeping)
+                m_condition.notify_all();
+
+            if (waiting)
+                m_waitCondition.notify_all();
+        }
+
+        /**
+        \fn bool Scheduler::HasPendingJobs(bool highPriorityOnly) const
+        \brief Returns whether any released job, or any High priority job, is waiting to run.
+        **/
+        bool Scheduler::HasPendingJobs(bool highPriorityOnly) const
+        {
+            if (highPriorityOnly)
+                return m_pendingJobs[static_cast<uint32_t>(JobPriority::High)].load(std::memory_order_seq_cst) > 0;
+
+            for (uint32_t i = 0; i < PriorityCount; i++)
+            {
+                if (m_pendingJobs[i].load(std::memory_order_seq_cst) > 0)
+                    return true;
+            }
+
+            return false;
+        }
+
+        /**
+        \fn IJob* Scheduler::FindJob(Worker* worker, JobPriority& priority)
+        \brief Finds next job for \a worker to run.
+
+        Looks through the priorities from High to Background.  Every
+        StarvationInterval jobs a worker looks from Background to High
+        instead, so lower priorities make progress under constant high
+        priority load.  Reserved workers only look at High priority.
+        \a worker may be null for threads outside the pool.  Returns nullptr
+        if no job was found, otherwise stores the job's priority in \a priority.
+        **/
+        IJob* Scheduler::FindJob(Worker* worker, JobPriority& priority)
+        {
+            if (worker && worker->m_highPriorityOnly)
+            {
+                priority = JobPriority::High;
+                return TakeJob(worker, static_cast<uint32_t>(JobPriority::High));
+            }
+
+            bool lowestFirst = worker && ++worker->m_jobsTaken % StarvationInterval == 0;
+            for (uint32_t i = 0; i < PriorityCount; i++)
+            {
+                uint32_t level = lowestFirst ? PriorityCount - 1 - i : i;
+                IJob* job = TakeJob(worker, level);
+                if (job)
+                {
+                    priority = static_cast<JobPriority>(level);
+                    return job;
+                }
+            }
+
+            return nullptr;
+        }
+
+        /**
+        \fn IJob* Scheduler::TakeJob(Worker* worker, uint32_t level)
+        \brief Takes a job of priority \a level for \a worker.
+
+        Checks the worker's own deque first, then tries to steal from the
+        other workers, then checks the shared queue.  \a worker may be null for threads outside the pool.  Returns
+        nullptr if no job was found.
+        **/
+        IJob* Scheduler::TakeJob(Worker* worker, uint32_t level)
+        {
+            if (m_pendingJobs[level].load(std::memory_order_relaxed) == 0)
+                return nullptr;
+
+            IJob* job = nullptr;
+            if (worker && worker->m_deques[level].pop(job))
+            {
+                m_pendingJobs[level].fetch_sub(1, std::memory_order_relaxed);
+                return job;
+            }
+
+            job = StealJob(worker, level);
+            if (job)
+            {
+                m_pendingJobs[level].fetch_sub(1, std::memory_order_relaxed);
+                if (worker && m_profiling.load(std::memory_order_relaxed))
+                    AddToCounter(worker->m_steals, 1);
+                return job;
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            job = m_readyJobs[level].Pop();
+            if (job)
+                m_pendingJobs[level].fetch_sub(1, std::memory_order_relaxed);
+
+            return job;
+        }
+
+        /**
+        \fn IJob* Scheduler::StealJob(Worker* worker, uint32_t level)
+        \brief Steals a job of priority \a level from a worker other than \a worker.
+
+        Victims are tried starting at a random one.  When workers are
+        grouped per NUMA node, workers on the thief's own node are tried
+        before any other.  Returns nullptr if every deque was empty.
+        **/
+        IJob* Scheduler::StealJob(Worker* worker, uint32_t level)
+        {
+            IJob* job = nullptr;
+
+            bool grouped = worker && m_groupByNode;
+            if (grouped)
+            {
+                const std::vector<uint32_t>& peers = m_nodeWorkers[worker->m_node];
+                uint32_t peerCount = static_cast<uint32_t>(peers.size());
+                uint32_t start = NextRandom(t_seed) % peerCount;
+                for (uint32_t i = 0; i < peerCount; i++)
+                {
+                    Worker* victim = m_workers[peers[(start + i) % peerCount]].get();
+                    if (victim != worker && victim->m_deques[level].steal(job))
+                        return job;
+                }
+            }
+
+            uint32_t workerCount = static_cast<uint32_t>(m_workers.size());
+            uint32_t start = workerCount > 0 ? NextRandom(t_seed) % workerCount : 0;
+            for (uint32_t i = 0; i < workerCount; i++)
+            {
+                Worker* victim = m_workers[(start + i) % workerCount].get();
+                if (victim == worker || (grouped && victim->m_node == worker->m_node))
+                    continue;
+
+                if (victim->m_deques[level].steal(job))
+                    return job;
+            }
+
+            return nullptr;
+        }
+
+        /**
+        \fn void Scheduler::RunJob(IJob* job, JobPriority priority)
+        \brief Runs \a job on the calling thread and releases it.
+
+        While profiling, records the job's timing.  Only the outermost job
+        on a thread counts towards busy time, since jobs run inside WaitFor
+        are already covered by the job waiting.
+        **/
+        void Scheduler::RunJob(IJob* job, JobPriority priority)
+        {
+            //Jobs may be run from inside WaitFor, so restore the outer priority
+            JobPriority outerPriority = t_priority;
+            t_priority = priority;
+
+            bool profiling = m_profiling.load(std::memory_order_relaxed);
+            uint64_t enqueueTime = job->m_enqueueTime;
+            uint64_t startTime = profiling ? JobProfiler::Now() : 0;
+
+            t_runDepth++;
+            job->Run();
+            t_runDepth--;
+
+            //Job has finished running, we can delete it
+            delete job;
+
+            t_priority = outerPriority;
+
+            if (profiling)
+            {
+                JobEvent event;
+                event.m_enqueueTime = enqueueTime != 0 ? enqueueTime : startTime;
+                event.m_startTime = startTime;
+                event.m_endTime = JobProfiler::Now();
+                event.m_worker = t_workerIndex;
+                event.m_priority = priority;
+                RecordJob(event);
+            }
+        }
+
+        /**
+        \fn void Scheduler::RecordJob(const JobEvent& event)
+        \brief Records \a event of a job that just finished on the calling thread.
+        **/
+        void Scheduler::RecordJob(const JobEvent& event)
+        {
+            if (t_workerIndex < 0)
+            {
+                m_externalEvents.Record(event);
+                return;
+            }
+
+            Worker* worker = m_workers[t_workerIndex].get();
+            worker->m_events.Record(event);
+            AddToCounter(worker->m_jobsRun, 1);
+            if (t_runDepth == 0)
+                AddToCounter(worker->m_busyTime, event.m_endTime - event.m_startTime);
+        }
+
+        /**
+        \fn void Scheduler::WorkerMain(Worker* worker)
+        \brief Main loop of a worker thread.
+
+        Runs jobs for as long as any can be found and parks on a condition
+        variable while no jobs it may run are pending.
+        **/
+        void Scheduler::WorkerMain(Worker* worker)
+        {
+            t_workerIndex = static_cast<int32_t>(worker->m_index);
+
+            if (worker->m_processor >= 0 && !CpuTopology::PinCurrentThread(static_cast<uint32_t>(worker->m_processor)))
+                HT_WARNING_PRINTF("Scheduler could not pin worker %u to processor %d\n", worker->m_index, worker->m_processor);
+
+            bool highPriorityOnly = worker->m_highPriorityOnly;
+            std::atomic<uint32_t>& sleepingCount = highPriorityOnly ? m_sleepingHighPriorityWorkers : m_sleepingWorkers;
+            std::condition_variable& condition = highPriorityOnly ? m_highPriorityCondition : m_condition;
+
+            for (;;)
+            {
+                JobPriority priority;
+                IJob* job = FindJob(worker, priority);
+                if (job)
+                {
+                    RunJob(job, priority);
+                    continue;
+                }
+
+                bool shutdown = false;
+                uint64_t idleStart = m_profiling.load(std::memory_order_relaxed) ? JobProfiler::Now() : 0;
+                sleepingCount.fetch_add(1, std::memory_order_seq_cst);
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    condition.wait(lock, [this, highPriorityOnly] {
+                        return m_shutdown || HasPendingJobs(highPriorityOnly);
+                    });
+                    shutdown = m_shutdown;
+                }
+                sleepingCount.fetch_sub(1, std::memory_order_seq_cst);
+
+                if (idleStart != 0)
+                    AddToCounter(worker->m_idleTime, JobProfiler::Now() - idleStart);
+
+                if (shutdown && !HasPendingJobs(highPriorityOnly))
+                    return;
+            }
+        }
+
+#if !defined(__cpp_aligned_new)
+        /**
+        \fn void* Scheduler::Worker::operator new(size_t size)
+        \brief Allocates a worker aligned to the cache lines of its deques.
+        **/
+        void* Scheduler::Worker::operator new(size_t size)
+        {
+            void* block = nullptr;
+#if defined(HT_SYS_WINDOWS)
+            block = _aligned_malloc(size, alignof(Worker));
+#else
+            if (posix_memalign(&block, alignof(Worker), size) != 0)
+                block = nullptr;
+#endif
+            if (!block)
+                throw std::bad_alloc();
+
+            return block;
+        }
+
+        /**
+        \fn void Scheduler::Worker::operator delete(void* block)
+        \brief Frees a worker allocated by Worker::operator new.
+        **/
+        void Scheduler::Worker::operator delete(void* block)
+        {
+#if defined(HT_SYS_WINDOWS)
+            _aligned_free(block);
+#else
+            free(block);
+#endif
+        }
+#endif
+
+        /**
+        \fn void Scheduler::ReadyQueue::Push(IJob* job)
+        \brief Appends \a job to the queue.  Caller must hold the scheduler mutex.
+        **/
+        void Scheduler::ReadyQueue::Push(IJob* job)
+        {
+            m_jobs.push_back(job);
+        }
+
+        /**
+        \fn IJob* Scheduler::ReadyQueue::Pop()
+        \brief Removes oldest job from the queue, or returns nullptr if empty.
+
+        Consumed entries are compacted away without releasing capacity.
+        Caller must hold the scheduler mutex.
+        **/
+        IJob* Scheduler::ReadyQueue::Pop()
+        {
+            if (m_head == m_jobs.size())
+                return nullptr;
+
+            IJob* job = m_jobs[m_head++];
+            if (m_head == m_jobs.size())
+            {
+                m_jobs.clear();
+                m_head = 0;
+            }
+            else if (m_head >= 64 && m_head * 2 >= m_jobs.size())
+            {
+                m_jobs.erase(m_jobs.begin(), m_jobs.begin() + m_head);
+                m_head = 0;
+            }
 
-            _instance.m_runningThreads--;
+            return job;
         }
     }
 
@@ -0,0 +1,120 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_task.h>
+
+#ifdef HT_HAS_COROUTINES
+
+#include <ht_file.h> //File
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \fn void TaskDispatcher::Resume(std::coroutine_handle<> coroutine, JobPriority priority)
+        \brief Resumes \a coroutine as a job with \a priority.
+        **/
+        void TaskDispatcher::Resume(std::coroutine_handle<> coroutine, JobPriority priority)
+        {
+            Scheduler::SpawnJob(priority, [coroutine]() { coroutine.resume(); });
+        }
+
+        /**
+        \fn JobPriority TaskDispatcher::GetCurrentPriority()
+        \brief Returns priority of the job running on the calling thread.
+        **/
+        JobPriority TaskDispatcher::GetCurrentPriority()
+        {
+            return Scheduler::GetCurrentPriority();
+        }
+
+        /**
+        \fn JobHandle TaskDispatcher::CreateHandle()
+        \brief Creates handle to be completed once by Complete.
+        **/
+        JobHandle TaskDispatcher::CreateHandle()
+        {
+            return Scheduler::CreateHandle();
+        }
+
+        /**
+        \fn void TaskDispatcher::Complete(const JobHandle& handle)
+        \brief Completes \a handle and wakes anyone waiting for it.
+        **/
+        void TaskDispatcher::Complete(const JobHandle& handle)
+        {
+            Scheduler::CompleteJob(handle);
+        }
+
+        /**
+        \fn FileReadAwaiter::FileReadAwaiter(std::string path)
+        \brief Creates awaiter reading file at \a path.
+        **/
+        FileReadAwaiter::FileReadAwaiter(std::string path)
+            : m_path(std::move(path)),
+            m_data(),
+            m_exception()
+        {}
+
+        /**
+        \fn void FileReadAwaiter::await_suspend(std::coroutine_handle<> coroutine)
+        \brief Reads the file on a Background job, then resumes \a coroutine.
+        **/
+        void FileReadAwaiter::await_suspend(std::coroutine_handle<> coroutine)
+        {
+            JobPriority priority = TaskDispatcher::GetCurrentPriority();
+
+            TaskDispatcher::Dispatch(JobPriority::Background, [this, coroutine, priority]() {
+                try
+                {
+                    File file;
+                    file.Open(m_path, File::FileMode::ReadBinary);
+                    m_data.resize(file.SizeBytes());
+                    m_data.resize(file.Read(m_data.data(), m_data.size()));
+                    file.Close();
+                }
+                catch (...)
+                {
+                    m_exception = std::current_exception();
+                }
+
+                TaskDispatcher::Resume(coroutine, priority);
+            });
+        }
+
+        /**
+        \fn std::vector<BYTE> FileReadAwaiter::await_resume()
+        \brief Returns contents of the file, or rethrows the error raised reading it.
+        **/
+        std::vector<BYTE> FileReadAwaiter::await_resume()
+        {
+            if (m_exception)
+                std::rethrow_exception(m_exception);
+
+            return std::move(m_data);
+        }
+
+        /**
+        \fn FileReadAwaiter ReadFileAsync(std::string path)
+        \brief Returns awaitable reading the whole file at \a path without blocking the awaiting worker.
+        **/
+        FileReadAwaiter ReadFileAsync(std::string path)
+        {
+            return FileReadAwaiter(std::move(path));
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,356 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_concurrentvector.h>
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \fn ConcurrentVector<T>::ConcurrentVector()
+        \brief Creates empty vector.  No segment is allocated until the first push_back.
+        **/
+        template <typename T>
+        ConcurrentVector<T>::ConcurrentVector()
+            : m_reserved(0),
+            m_size(0)
+        {
+            for (size_t i = 0; i < SegmentCount; i++)
+                m_segments[i].store(nullptr, std::memory_order_relaxed);
+        }
+
+        /**
+        \fn ConcurrentVector<T>::~ConcurrentVector()
+        \brief Destroys every element and releases all segments.
+
+        No other thread may use the vector while it is destroyed.
+        **/
+        template <typename T>
+        ConcurrentVector<T>::~ConcurrentVector()
+        {
+            size_t count = m_size.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; i++)
+                reinterpret_cast<T*>(&GetSlot(i).m_storage)->~T();
+
+            for (size_t i = 0; i < SegmentCount; i++)
+                delete[] m_segments[i].load(std::memory_order_relaxed);
+        }
+
+        /**
+        \fn size_t ConcurrentVector<T>::push_back(const T& _val)
+        \brief Appends copy of \a _val and returns its index.
+        **/
+        template <typename T>
+        size_t ConcurrentVector<T>::push_back(const T& _val)
+        {
+            return emplace_back(_val);
+        }
+
+        /**
+        \fn size_t ConcurrentVector<T>::push_back(T&& _val)
+        \brief Appends \a _val and returns its index.
+        **/
+        template <typename T>
+        size_t ConcurrentVector<T>::push_back(T&& _val)
+        {
+            return emplace_back(std::move(_val));
+        }
+
+        /**
+        \fn size_t ConcurrentVector<T>::emplace_back(Args&&... arguments)
+        \brief Appends element constructed from \a arguments and returns its index.
+
+        The element is visible to readers once it and every element before
+        it have been constructed.  If its constructor throws, nothing is
+        appended.
+        **/
+        template <typename T>
+        template <class... Args>
+        size_t ConcurrentVector<T>::emplace_back(Args&&... arguments)
+        {
+            return Emplace(std::is_nothrow_constructible<T, Args&&...>(), std::forward<Args>(arguments)...);
+        }
+
+        /**
+        \fn T& ConcurrentVector<T>::operator[](size_t pos)
+        \brief Returns element at \a pos, which must be less than size().
+        **/
+        template <typename T>
+        T& ConcurrentVector<T>::operator[](size_t pos)
+        {
+            assert(pos < size());
+            return *reinterpret_cast<T*>(&GetSlot(pos).m_storage);
+        }
+
+        /**
+        \fn const T& ConcurrentVector<T>::operator[](size_t pos) const
+        \brief Returns element at \a pos, which must be less than size().
+        **/
+        template <typename T>
+        const T& ConcurrentVector<T>::operator[](size_t pos) const
+        {
+            assert(pos < size());
+            return *reinterpret_cast<const T*>(&GetSlot(pos).m_storage);
+        }
+
+        /**
+        \fn ConcurrentVector<T>::iterator ConcurrentVector<T>::begin()
+        \brief Returns iterator to the first element.
+        **/
+        template <typename T>
+        typename ConcurrentVector<T>::iterator ConcurrentVector<T>::begin()
+        {
+            return iterator(this, 0);
+        }
+
+        /**
+        \fn ConcurrentVector<T>::iterator ConcurrentVector<T>::end()
+        \brief Returns iterator past the last element visible at the time of the call.
+
+        Elements appended afterwards are not part of the iterated range.
+        **/
+        template <typename T>
+        typename ConcurrentVector<T>::iterator ConcurrentVector<T>::end()
+        {
+            return iterator(this, size());
+        }
+
+        template <typename T>
+        typename ConcurrentVector<T>::const_iterator ConcurrentVector<T>::begin() const
+        {
+            return const_iterator(this, 0);
+        }
+
+        template <typename T>
+        typename ConcurrentVector<T>::const_iterator ConcurrentVector<T>::end() const
+        {
+            return const_iterator(this, size());
+        }
+
+        /**
+        \fn size_t ConcurrentVector<T>::size() const
+        \brief Returns number of elements visible to readers.
+        **/
+        template <typename T>
+        size_t ConcurrentVector<T>::size() const
+        {
+            return m_size.load(std::memory_order_acquire);
+        }
+
+        /**
+        \fn bool ConcurrentVector<T>::empty() const
+        \brief Returns whether no element is visible to readers.
+        **/
+        template <typename T>
+        bool ConcurrentVector<T>::empty() const
+        {
+            return size() == 0;
+        }
+
+        /**
+        \fn size_t ConcurrentVector<T>::HighestBit(size_t value)
+        \brief Returns position of the highest set bit of non-zero \a value.
+        **/
+        template <typename T>
+        size_t ConcurrentVector<T>::HighestBit(size_t value)
+        {
+#if defined(_MSC_VER)
+            unsigned long bit;
+            _BitScanReverse64(&bit, static_cast<unsigned __int64>(value));
+            return bit;
+#else
+            return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(static_cast<unsigned long long>(value));
+#endif
+        }
+
+        /**
+        \fn size_t ConcurrentVector<T>::SegmentOf(size_t index, size_t& offset)
+        \brief Returns segment holding element \a index and stores its position there in \a offset.
+
+        Segment k holds 2^(FirstSegmentBits + k) elements, so shifting the
+        index by the size of the first segment turns its highest bit into
+        the segment number.
+        **/
+        template <typename T>
+        size_t ConcurrentVector<T>::SegmentOf(size_t index, size_t& offset)
+        {
+            size_t shifted = index + (static_cast<size_t>(1) << FirstSegmentBits);
+            size_t bit = HighestBit(shifted);
+
+            offset = shifted - (static_cast<size_t>(1) << bit);
+            return bit - FirstSegmentBits;
+        }
+
+        /**
+        \fn size_t ConcurrentVector<T>::SegmentSize(size_t segment)
+        \brief Returns number of elements in \a segment.
+        **/
+        template <typename T>
+        size_t ConcurrentVector<T>::SegmentSize(size_t segment)
+        {
+            return static_cast<size_t>(1) << (FirstSegmentBits + segment);
+        }
+
+        /**
+        \fn size_t ConcurrentVector<T>::Emplace(std::true_type, Args&&... arguments)
+        \brief Reserves a slot and constructs the element from \a arguments in place.
+
+        The constructor must not throw, since a reserved slot that is never
+        marked ready would stop size() from advancing past it.
+        **/
+        template <typename T>
+        template <class... Args>
+        size_t ConcurrentVector<T>::Emplace(std::true_type, Args&&... arguments)
+        {
+            size_t index = m_reserved.fetch_add(1, std::memory_order_relaxed);
+
+            Slot& slot = AcquireSlot(index);
+            new (&slot.m_storage) T(std::forward<Args>(arguments)...);
+            slot.m_ready.store(true, std::memory_order_seq_cst);
+
+            Commit();
+            return index;
+        }
+
+        /**
+        \fn size_t ConcurrentVector<T>::Emplace(std::false_type, Args&&... arguments)
+        \brief Constructs the element from \a arguments, then moves it into a reserved slot.
+        **/
+        template <typename T>
+        template <class... Args>
+        size_t ConcurrentVector<T>::Emplace(std::false_type, Args&&... arguments)
+        {
+            T value(std::forward<Args>(arguments)...);
+
+            return Emplace(std::true_type(), std::move(value));
+        }
+
+        /**
+        \fn Slot& ConcurrentVector<T>::GetSlot(size_t index) const
+        \brief Returns slot of element \a index, whose segment must exist.
+        **/
+        template <typename T>
+        typename ConcurrentVector<T>::Slot& ConcurrentVector<T>::GetSlot(size_t index) const
+        {
+            size_t offset;
+            size_t segment = SegmentOf(index, offset);
+
+            return m_segments[segment].load(std::memory_order_acquire)[offset];
+        }
+
+        /**
+        \fn Slot& ConcurrentVector<T>::AcquireSlot(size_t index)
+        \brief Returns slot of element \a index, allocating its segment if needed.
+
+        Threads racing to allocate the same segment install theirs with a
+        CAS; the losers release their allocation and use the winner's.
+        **/
+        template <typename T>
+        typename ConcurrentVector<T>::Slot& ConcurrentVector<T>::AcquireSlot(size_t index)
+        {
+            size_t offset;
+            size_t segment = SegmentOf(index, offset);
+
+            Slot* slots = m_segments[segment].load(std::memory_order_acquire);
+            if (!slots)
+            {
+                Slot* allocated = new Slot[SegmentSize(segment)]();
+                if (m_segments[segment].compare_exchange_strong(slots, allocated, std::memory_order_acq_rel, std::memory_order_acquire))
+                    slots = allocated;
+                else
+                    delete[] allocated;
+            }
+
+            return slots[offset];
+        }
+
+        /**
+        \fn void ConcurrentVector<T>::Commit()
+        \brief Advances size() past every constructed element following it.
+
+        Every thread finishing an element tries to advance the size, so the
+        element holding it back always moves it on once it is constructed.
+        **/
+        template <typename T>
+        void ConcurrentVector<T>::Commit()
+        {
+            size_t count = m_size.load(std::memory_order_seq_cst);
+            while (count < m_reserved.load(std::memory_order_relaxed))
+            {
+                //The thread that reserved the next element may not have allocated its segment yet
+                size_t offset;
+                Slot* slots = m_segments[SegmentOf(count, offset)].load(std::memory_order_seq_cst);
+                if (!slots || !slots[offset].m_ready.load(std::memory_order_seq_cst))
+                    break;
+
+                m_size.compare_exchange_weak(count, count + 1, std::memory_order_seq_cst);
+            }
+        }
+
+        template <typename T>
+        template <class Value>
+        ConcurrentVector<T>::Iterator<Value>::Iterator(const ConcurrentVector* vector, size_t index)
+            : m_vector(vector),
+            m_index(index)
+        {}
+
+        template <typename T>
+        template <class Value>
+        typename ConcurrentVector<T>::template Iterator<Value>::reference ConcurrentVector<T>::Iterator<Value>::operator*() const
+        {
+            return *reinterpret_cast<Value*>(&m_vector->GetSlot(m_index).m_storage);
+        }
+
+        template <typename T>
+        template <class Value>
+        typename ConcurrentVector<T>::template Iterator<Value>::pointer ConcurrentVector<T>::Iterator<Value>::operator->() const
+        {
+            return reinterpret_cast<Value*>(&m_vector->GetSlot(m_index).m_storage);
+        }
+
+        template <typename T>
+        template <class Value>
+        typename ConcurrentVector<T>::template Iterator<Value>& ConcurrentVector<T>::Iterator<Value>::operator++()
+        {
+            m_index++;
+            return *this;
+        }
+
+        template <typename T>
+        template <class Value>
+        typename ConcurrentVector<T>::template Iterator<Value> ConcurrentVector<T>::Iterator<Value>::operator++(int)
+        {
+            Iterator previous = *this;
+            m_index++;
+            return previous;
+        }
+
+        template <typename T>
+        template <class Value>
+        bool ConcurrentVector<T>::Iterator<Value>::operator==(const Iterator& rhs) const
+        {
+            return m_index == rhs.m_index && m_vector == rhs.m_vector;
+        }
+
+        template <typename T>
+        template <class Value>
+        bool ConcurrentVector<T>::Iterator<Value>::operator!=(const Iterator& rhs) const
+        {
+            return !(*this == rhs);
+        }
+    }
+}
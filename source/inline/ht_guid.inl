@@ -16,6 +16,57 @@
 
 #include <ht_guid.h>
 
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \fn constexpr GuidLiteral::GuidLiteral(const char* text, size_t length)
+        \brief Hashes both halves of \a text, then the resulting 16 bytes, like Guid::FromString.
+        **/
+        inline constexpr GuidLiteral::GuidLiteral(const char* text, size_t length)
+            : m_first(GetFnv1aHash(text, length / 2, 0)),
+            m_second(GetFnv1aHash(text + length / 2, length - length / 2, 0)),
+            m_hashCode(GetFnv1aHash(GetFnv1aHash(text, length / 2, 0), GetFnv1aHash(text + length / 2, length - length / 2, 0), 0, 0)),
+            m_text(text),
+            m_length(length)
+        {}
+
+        /**
+        \fn constexpr uint64_t GuidLiteral::GetFnv1aHash(const char* text, size_t length, uint64_t hash)
+        \brief Continues FNV-1a \a hash over \a length characters, matching the hash Guid uses at runtime.
+
+        Recurses once per character, so literals longer than twice the
+        compiler's constexpr depth limit are only hashed at runtime.
+        **/
+        inline constexpr uint64_t GuidLiteral::GetFnv1aHash(const char* text, size_t length, uint64_t hash)
+        {
+            return length == 0 ? hash
+                : GetFnv1aHash(text + 1, length - 1, (hash ^ static_cast<uint8_t>(text[0])) * 0x100000001b3ULL);
+        }
+
+        /**
+        \fn constexpr uint64_t GuidLiteral::GetFnv1aHash(uint64_t first, uint64_t second, int index, uint64_t hash)
+        \brief Continues FNV-1a \a hash over the little-endian bytes of \a first followed by \a second.
+        **/
+        inline constexpr uint64_t GuidLiteral::GetFnv1aHash(uint64_t first, uint64_t second, int index, uint64_t hash)
+        {
+            return index == 16 ? hash
+                : GetFnv1aHash(first, second, index + 1,
+                    (hash ^ (((index < 8 ? first : second) >> ((index % 8) * 8)) & 0xFF)) * 0x100000001b3ULL);
+        }
+
+        /**
+        \fn constexpr GuidLiteral operator"" _guid(const char* text, size_t length)
+        \brief Creates GuidLiteral from string literal, i.e. "textures/grass"_guid.
+        **/
+        inline constexpr GuidLiteral operator"" _guid(const char* text, size_t length)
+        {
+            return GuidLiteral(text, length);
+        }
+    }
+}
+
 namespace std
 {
     inline size_t hash<Hatchit::Core::Guid>::operator()(const Hatchit::Core::Guid& guid) const
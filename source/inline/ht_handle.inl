@@ -11,7 +11,7 @@ namespace Hatchit
         \brief Creates an invalid handle.
         **/
         template<typename VarType>
-        inline Handle<VarType>::Handle() : m_ptr(), m_refCount(), m_ID() {}
+        inline Handle<VarType>::Handle() : m_ptr(), m_counted() {}
 
         /**
         \fn Handle<T>::Handle(const Handle<T>& rhs)
@@ -20,11 +20,10 @@ namespace Hatchit
         template<typename VarType>
         inline Handle<VarType>::Handle(const Handle<VarType>& rhs)
             : m_ptr(rhs.m_ptr),
-            m_refCount(rhs.m_refCount),
-            m_ID(rhs.m_ID)
+            m_counted(rhs.m_counted)
         {
-            if (m_refCount)
-                ++(*m_refCount);
+            if (m_counted)
+                m_counted->AddReference();
         }
 
         /**
@@ -33,13 +32,11 @@ namespace Hatchit
         **/
         template<typename VarType>
         inline Handle<VarType>::Handle(Handle<VarType>&& rhs)
-            : m_ptr(std::move(rhs.m_ptr)),
-            m_refCount(std::move(rhs.m_refCount)),
-            m_ID(std::move(rhs.m_ID))
+            : m_ptr(rhs.m_ptr),
+            m_counted(rhs.m_counted)
         {
             rhs.m_ptr = nullptr;
-            rhs.m_refCount = nullptr;
-            rhs.m_ID = nullptr;
+            rhs.m_counted = nullptr;
         }
 
         /**
@@ -52,10 +49,7 @@ namespace Hatchit
         template<typename VarType>
         inline Handle<VarType>::~Handle()
         {
-            if (m_refCount && !--(*m_refCount))
-            {
-                RefCountedResourceManager::ReleaseRawPointer<VarType>(*m_ID);
-            }
+            ReleaseReference();
         }
 
         /**
@@ -68,17 +62,13 @@ namespace Hatchit
         template<typename VarType>
         inline Handle<VarType>& Handle<VarType>::operator=(const Handle<VarType>& rhs)
         {
-            if (rhs.m_refCount)
-                ++(*rhs.m_refCount);
+            if (rhs.m_counted)
+                rhs.m_counted->AddReference();
 
-            if (m_refCount && !--(*m_refCount))
-            {
-                RefCountedResourceManager::ReleaseRawPointer<VarType>(*m_ID);
-            }
+            ReleaseReference();
 
             m_ptr = rhs.m_ptr;
-            m_refCount = rhs.m_refCount;
-            m_ID = rhs.m_ID;
+            m_counted = rhs.m_counted;
 
             return *this;
         }
@@ -94,17 +84,16 @@ namespace Hatchit
         template<typename VarType>
         inline Handle<VarType>& Handle<VarType>::operator=(Handle<VarType>&& rhs)
         {
-            if (m_refCount && !--(*m_refCount))
-            {
-                RefCountedResourceManager::ReleaseRawPointer<VarType>(*m_ID);
-            }
-            m_ptr = std::move(rhs.m_ptr);
-            m_refCount = std::move(rhs.m_refCount);
-            m_ID = std::move(rhs.m_ID);
+            if (this == &rhs)
+                return *this;
+
+            ReleaseReference();
+
+            m_ptr = rhs.m_ptr;
+            m_counted = rhs.m_counted;
 
             rhs.m_ptr = nullptr;
-            rhs.m_refCount = nullptr;
-            rhs.m_ID = nullptr;
+            rhs.m_counted = nullptr;
 
             return *this;
         }
@@ -116,7 +105,7 @@ namespace Hatchit
         template<typename VarType>
         inline VarType* Handle<VarType>::operator->() const
         {
-            return m_ptr;
+            return Resolve(std::is_base_of<RefCountedBase, VarType>());
         }
 
         /**
@@ -186,7 +175,7 @@ namespace Hatchit
         {
             NewResourceType* newPtr = dynamic_cast<NewResourceType*>(m_ptr);
             if (newPtr)
-                return Handle<NewResourceType>(newPtr, m_refCount, m_ID);
+                return Handle<NewResourceType>(newPtr, m_counted);
             else
                 return Handle<NewResourceType>();
         }
@@ -203,7 +192,7 @@ namespace Hatchit
         inline Handle<NewResourceType> Handle<VarType>::StaticCastHandle() const
         {
             NewResourceType* newPtr = static_cast<NewResourceType*>(m_ptr);
-            return Handle<NewResourceType>(newPtr, m_refCount, m_ID);
+            return Handle<NewResourceType>(newPtr, m_counted);
         }
 
         /**
@@ -216,7 +205,29 @@ namespace Hatchit
         template<typename VarType>
         inline bool Handle<VarType>::IsValid() const
         {
-            return m_ptr != nullptr;
+            return operator->() != nullptr;
+        }
+
+        /**
+        \fn bool Handle<T>::IsLoaded() const
+        \brief Returns whether the referenced resource finished loading.
+        **/
+        template<typename VarType>
+        inline bool Handle<VarType>::IsLoaded() const
+        {
+            return m_counted && m_counted->IsLoaded();
+        }
+
+        /**
+        \fn JobHandle Handle<T>::GetLoadJob() const
+        \brief Returns handle to the job loading the referenced resource.
+
+        Invalid unless the resource is loaded by GetHandleAsync.
+        **/
+        template<typename VarType>
+        inline JobHandle Handle<VarType>::GetLoadJob() const
+        {
+            return m_counted ? m_counted->GetLoadJob() : JobHandle();
         }
 
         /**
@@ -225,47 +236,72 @@ namespace Hatchit
 
         Dereferences the handle's values so that the reference count to the
         currently pointed to object is decremented, as if the handle was deleted.
-        \note: Currently forces the release of the resource.  This is to be fixed
-        in a future update.
+        The resource is released once no other handle refers to it.
         **/
         template<typename VarType>
         inline void Handle<VarType>::Release()
         {
-            //For time being, we force release the resource
-            RefCountedResourceManager::ReleaseRawPointer<VarType>(*m_ID);
-        
-            //Ideally, we want to return to this solution
-            //if (m_refCount && !--(*m_refCount))
-            //{
-            //    //Delete referenced counter
-            //    RefCountedResourceManager::ReleaseRawPointer<VarType>(*m_ID);
-            //}
+            ReleaseReference();
 
             m_ptr = nullptr;
-            m_refCount = nullptr;
-            m_ID = nullptr;
+            m_counted = nullptr;
+        }
+
+        /**
+        \fn Handle<T>::Handle(T* varPtr, RefCountedBase* counted, bool addReference)
+        \brief Creates handle from raw pointer and the RefCountedBase counting it.
+
+        Creates handle to \a varPtr which keeps \a counted alive.  Usually
+        both are the same object; handles to placeholder resources point at
+        the placeholder while counting the resource being loaded.  Adopts a
+        reference already taken for the handle unless \a addReference is set.
+        **/
+        template<typename VarType>
+        inline Handle<VarType>::Handle(VarType* varPtr, RefCountedBase* counted, bool addReference)
+            : m_ptr(varPtr),
+            m_counted(counted)
+        {
+            if (m_counted && addReference)
+                m_counted->AddReference();
         }
 
         /**
-        \fn Handle<T>::Handle(
-            T* varPtr, 
-            uint32_t* refCounter, 
-            const std::string* name)
-        \brief Creates handle from raw pointer and pointers to 
-            reference count and name.
-
-        Creates handle from raw pointer and pointers to 
-        reference counter and name.  varPtr must be a pointer to an object that
-        derives from RefCounted.
+        \fn void Handle<T>::ReleaseReference()
+        \brief Drops reference held by handle, releasing the resource if it was the last.
+        **/
+        template<typename VarType>
+        inline void Handle<VarType>::ReleaseReference()
+        {
+            if (m_counted && m_counted->RemoveReference())
+                RefCountedResourceManager::ReleaseRawPointer<VarType>(m_counted->GetID());
+        }
+
+        /**
+        \fn T* Handle<T>::Resolve(std::true_type) const
+        \brief Returns the resource once it has loaded, the pointed to placeholder until then.
+
+        Only handles returned by GetHandleAsync point at something else than
+        their counted resource, so other handles never look at the load state.
         **/
         template<typename VarType>
-        inline Handle<VarType>::Handle(VarType* varPtr, uint32_t* refCounter, const Guid* ID)
-            : m_ptr(std::move(varPtr)),
-            m_refCount(refCounter),
-            m_ID(std::move(ID))
+        inline VarType* Handle<VarType>::Resolve(std::true_type) const
         {
-            if (refCounter)
-                ++(*refCounter);
+            if (m_counted && static_cast<RefCountedBase*>(m_ptr) != m_counted && m_counted->IsLoaded())
+                return static_cast<VarType*>(m_counted);
+
+            return m_ptr;
+        }
+
+        /**
+        \fn T* Handle<T>::Resolve(std::false_type) const
+        \brief Returns the pointed to object for types not derived from RefCountedBase.
+
+        Handles cast to such types keep pointing at a placeholder.
+        **/
+        template<typename VarType>
+        inline VarType* Handle<VarType>::Resolve(std::false_type) const
+        {
+            return m_ptr;
         }
     }
-}
\ No newline at end of file
+}
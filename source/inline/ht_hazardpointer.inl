@@ -0,0 +1,64 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_hazardpointer.h>
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \fn T* HazardPointer::protect(const std::atomic<T*>& source)
+        \brief Loads \a source and protects the loaded pointer from reclamation.
+
+        The pointer is published and \a source re-read until both agree, so
+        the returned object cannot have been retired and deleted before it
+        was protected.  It stays safe to dereference until reset or the
+        next protect.
+        **/
+        template <typename T>
+        T* HazardPointer::protect(const std::atomic<T*>& source)
+        {
+            T* pointer = source.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                m_slot->store(pointer, std::memory_order_seq_cst);
+
+                T* current = source.load(std::memory_order_seq_cst);
+                if (current == pointer)
+                    return pointer;
+
+                pointer = current;
+            }
+        }
+
+        /**
+        \fn void HazardPointer::Retire(T* pointer)
+        \brief Deletes \a pointer once no hazard pointer protects it.
+        **/
+        template <typename T>
+        void HazardPointer::Retire(T* pointer)
+        {
+            Retire(pointer, &HazardPointer::Delete<T>);
+        }
+
+        template <typename T>
+        void HazardPointer::Delete(void* pointer)
+        {
+            delete static_cast<T*>(pointer);
+        }
+    }
+}
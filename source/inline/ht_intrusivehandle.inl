@@ -0,0 +1,226 @@
+#pragma once
+
+#include <ht_refcounted.h>
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \fn IntrusiveHandle<T>::IntrusiveHandle()
+        \brief Creates an invalid handle.
+        **/
+        template<typename VarType>
+        inline IntrusiveHandle<VarType>::IntrusiveHandle() : m_ptr() {}
+
+        /**
+        \fn IntrusiveHandle<T>::IntrusiveHandle(const Handle<T>& handle)
+        \brief Creates handle to the resource referenced by \a handle.
+
+        Adds a reference to the resource.  If \a handle still points at a
+        placeholder for a resource that is loading, the intrusive handle is
+        invalid.
+        **/
+        template<typename VarType>
+        inline IntrusiveHandle<VarType>::IntrusiveHandle(const Handle<VarType>& handle)
+            : m_ptr()
+        {
+            static_assert(sizeof(IntrusiveHandle<VarType>) == sizeof(VarType*),
+                "IntrusiveHandle must stay a single pointer");
+
+            VarType* resource = handle.operator->();
+            if (resource && static_cast<RefCountedBase*>(resource) == handle.m_counted)
+            {
+                m_ptr = resource;
+                handle.m_counted->AddReference();
+            }
+        }
+
+        /**
+        \fn IntrusiveHandle<T>::IntrusiveHandle(const IntrusiveHandle<T>& rhs)
+        \brief Copies reference to resource and increments reference counter.
+        **/
+        template<typename VarType>
+        inline IntrusiveHandle<VarType>::IntrusiveHandle(const IntrusiveHandle<VarType>& rhs)
+            : m_ptr(rhs.m_ptr)
+        {
+            if (m_ptr)
+                static_cast<RefCountedBase*>(m_ptr)->AddReference();
+        }
+
+        /**
+        \fn IntrusiveHandle<T>::IntrusiveHandle(IntrusiveHandle<T>&& rhs)
+        \brief Moves reference from temp object to new handle.
+        **/
+        template<typename VarType>
+        inline IntrusiveHandle<VarType>::IntrusiveHandle(IntrusiveHandle<VarType>&& rhs)
+            : m_ptr(rhs.m_ptr)
+        {
+            rhs.m_ptr = nullptr;
+        }
+
+        /**
+        \fn IntrusiveHandle<T>::~IntrusiveHandle()
+        \brief Decreases reference count of resource.
+
+        Decreases reference count of resource.  If reference count reaches
+        zero, then resource is released.
+        **/
+        template<typename VarType>
+        inline IntrusiveHandle<VarType>::~IntrusiveHandle()
+        {
+            ReleaseReference();
+        }
+
+        /**
+        \fn IntrusiveHandle<T>& IntrusiveHandle<T>::operator=(const IntrusiveHandle<T>& rhs)
+        \brief Assigns handle to reference of \a rhs handle.
+
+        Assigns handle to reference of \a rhs handle.  Reference counts are
+        decremented for this handle and incremented for \a rhs.
+        **/
+        template<typename VarType>
+        inline IntrusiveHandle<VarType>& IntrusiveHandle<VarType>::operator=(const IntrusiveHandle<VarType>& rhs)
+        {
+            if (rhs.m_ptr)
+                static_cast<RefCountedBase*>(rhs.m_ptr)->AddReference();
+
+            ReleaseReference();
+
+            m_ptr = rhs.m_ptr;
+
+            return *this;
+        }
+
+        /**
+        \fn IntrusiveHandle<T>& IntrusiveHandle<T>::operator=(IntrusiveHandle<T>&& rhs)
+        \brief Moves reference of \a rhs handle into this handle.
+
+        Reference count is decremented for this handle, and \a rhs is
+        left invalid.
+        **/
+        template<typename VarType>
+        inline IntrusiveHandle<VarType>& IntrusiveHandle<VarType>::operator=(IntrusiveHandle<VarType>&& rhs)
+        {
+            if (this == &rhs)
+                return *this;
+
+            ReleaseReference();
+
+            m_ptr = rhs.m_ptr;
+            rhs.m_ptr = nullptr;
+
+            return *this;
+        }
+
+        /**
+        \fn T* IntrusiveHandle<T>::operator->() const
+        \brief Returns pointer to internal type for function / member operators
+        **/
+        template<typename VarType>
+        inline VarType* IntrusiveHandle<VarType>::operator->() const
+        {
+            return m_ptr;
+        }
+
+        /**
+        \fn IntrusiveHandle<T>::operator>(const IntrusiveHandle<T>& rhs) const
+        \brief Comparison function for sorting handles
+        **/
+        template<typename VarType>
+        inline bool IntrusiveHandle<VarType>::operator>(const IntrusiveHandle<VarType>& rhs) const
+        {
+            return m_ptr > rhs.m_ptr;
+        }
+
+        /**
+        \fn IntrusiveHandle<T>::operator<(const IntrusiveHandle<T>& rhs) const
+        \brief Comparison function for sorting handles
+        **/
+        template<typename VarType>
+        inline bool IntrusiveHandle<VarType>::operator<(const IntrusiveHandle<VarType>& rhs) const
+        {
+            return m_ptr < rhs.m_ptr;
+        }
+
+        /**
+        \fn IntrusiveHandle<T>::operator==(const IntrusiveHandle<T>& rhs) const
+        \brief Comparison function for sorting handles
+        **/
+        template<typename VarType>
+        inline bool IntrusiveHandle<VarType>::operator==(const IntrusiveHandle<VarType>& rhs) const
+        {
+            return m_ptr == rhs.m_ptr;
+        }
+
+        /**
+        \fn IntrusiveHandle<T>::operator!=(const IntrusiveHandle<T>& rhs) const
+        \brief Comparison function for sorting handles
+        **/
+        template<typename VarType>
+        inline bool IntrusiveHandle<VarType>::operator!=(const IntrusiveHandle<VarType>& rhs) const
+        {
+            return m_ptr != rhs.m_ptr;
+        }
+
+        /**
+        \fn Handle<T> IntrusiveHandle<T>::GetHandle() const
+        \brief Returns a Handle to the same resource.
+        **/
+        template<typename VarType>
+        inline Handle<VarType> IntrusiveHandle<VarType>::GetHandle() const
+        {
+            if (!m_ptr)
+                return Handle<VarType>();
+
+            return Handle<VarType>(m_ptr, m_ptr);
+        }
+
+        /**
+        \fn const Guid& IntrusiveHandle<T>::GetID() const
+        \brief Returns ID of the referenced resource.
+
+        Handle must be valid.
+        **/
+        template<typename VarType>
+        inline const Guid& IntrusiveHandle<VarType>::GetID() const
+        {
+            return static_cast<RefCountedBase*>(m_ptr)->GetID();
+        }
+
+        /**
+        \fn bool IntrusiveHandle<T>::IsValid() const
+        \brief Returns whether handle points to valid resource
+        **/
+        template<typename VarType>
+        inline bool IntrusiveHandle<VarType>::IsValid() const
+        {
+            return m_ptr != nullptr;
+        }
+
+        /**
+        \fn void IntrusiveHandle<T>::Release()
+        \brief Dereferences handle's values, as if the handle was deleted.
+
+        The resource is released once no other handle refers to it.
+        **/
+        template<typename VarType>
+        inline void IntrusiveHandle<VarType>::Release()
+        {
+            ReleaseReference();
+
+            m_ptr = nullptr;
+        }
+
+        /**
+        \fn void IntrusiveHandle<T>::ReleaseReference()
+        \brief Drops reference held by handle, releasing the resource if it was the last.
+        **/
+        template<typename VarType>
+        inline void IntrusiveHandle<VarType>::ReleaseReference()
+        {
+            if (m_ptr && static_cast<RefCountedBase*>(m_ptr)->RemoveReference())
+                RefCountedResourceManager::ReleaseRawPointer<VarType>(GetID());
+        }
+    }
+}
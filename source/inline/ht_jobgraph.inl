@@ -0,0 +1,22 @@
+#pragma once
+
+#include <ht_jobgraph.h>
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \fn JobGraph::NodeID JobGraph::AddJob(Func&& function, Args&&... arguments)
+        \brief Adds job to the graph and returns its node ID.
+
+        The function and arguments are copied into the graph so it can be
+        scheduled any number of times.
+        **/
+        template<class Func, class... Args>
+        inline JobGraph::NodeID JobGraph::AddJob(Func&& function, Args&&... arguments)
+        {
+            return AddNode(std::bind(std::forward<Func>(function), std::forward<Args>(arguments)...));
+        }
+    }
+}
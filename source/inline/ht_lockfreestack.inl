@@ -0,0 +1,237 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_lockfreestack.h>
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \fn LockFreeStack<T>::LockFreeStack()
+        \brief Creates empty lock-free stack.
+        **/
+        template <typename T>
+        LockFreeStack<T>::LockFreeStack()
+            : m_head(nullptr)
+        {}
+
+        /**
+        \fn LockFreeStack<T>::~LockFreeStack()
+        \brief Destroys every element left on the stack.
+
+        No other thread may use the stack while it is destroyed.
+        **/
+        template <typename T>
+        LockFreeStack<T>::~LockFreeStack()
+        {
+            Node* node = m_head.load(std::memory_order_acquire);
+            while (node)
+            {
+                Node* next = node->m_next;
+                DestroyNode(node);
+                node = next;
+            }
+        }
+
+        /**
+        \fn void LockFreeStack<T>::push(T _val)
+        \brief Adds \a _val to the top of the stack.
+        **/
+        template <typename T>
+        void LockFreeStack<T>::push(T _val)
+        {
+            Node* node = CreateNode(std::move(_val), m_head.load(std::memory_order_relaxed));
+            while (!m_head.compare_exchange_weak(node->m_next, node, std::memory_order_release, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        /**
+        \fn std::shared_ptr<T> LockFreeStack<T>::pop()
+        \brief Removes top element and returns a shared ptr holding it.
+
+        \exception std::exception The stack is empty.
+        **/
+        template <typename T>
+        std::shared_ptr<T> LockFreeStack<T>::pop()
+        {
+            Node* node = PopNode();
+            if (!node)
+                throw std::exception();
+
+            std::shared_ptr<T> const result = std::make_shared<T>(std::move(node->m_value));
+            HazardPointer::Retire(node, &LockFreeStack<T>::DestroyNode);
+
+            return result;
+        }
+
+        /**
+        \fn void LockFreeStack<T>::pop(T& _val)
+        \brief Removes top element and moves it into \a _val.
+
+        \exception std::exception The stack is empty.
+        **/
+        template <typename T>
+        void LockFreeStack<T>::pop(T& _val)
+        {
+            if (!try_pop(_val))
+                throw std::exception();
+        }
+
+        /**
+        \fn bool LockFreeStack<T>::try_pop(T& _val)
+        \brief Removes top element and moves it into \a _val if the stack is not empty.
+
+        \return Whether an element was popped.
+        **/
+        template <typename T>
+        bool LockFreeStack<T>::try_pop(T& _val)
+        {
+            Node* node = PopNode();
+            if (!node)
+                return false;
+
+            _val = std::move(node->m_value);
+            HazardPointer::Retire(node, &LockFreeStack<T>::DestroyNode);
+
+            return true;
+        }
+
+        /**
+        \fn bool LockFreeStack<T>::empty() const
+        \brief Returns whether the stack held no elements when checked.
+        **/
+        template <typename T>
+        bool LockFreeStack<T>::empty() const
+        {
+            return m_head.load(std::memory_order_acquire) == nullptr;
+        }
+
+        /**
+        \fn LockFreeStack<T>::Node* LockFreeStack<T>::PopNode()
+        \brief Unlinks top node, or returns nullptr if the stack is empty.
+
+        The head is protected while its next pointer is read, so it cannot
+        be reclaimed and reused underneath the CAS.  Only the thread that
+        unlinked a node touches its value, and it must retire the node.
+        **/
+        template <typename T>
+        typename LockFreeStack<T>::Node* LockFreeStack<T>::PopNode()
+        {
+            HazardPointer hazard;
+
+            Node* node = hazard.protect(m_head);
+            while (node)
+            {
+                Node* next = node->m_next;
+                if (m_head.compare_exchange_strong(node, next, std::memory_order_acquire, std::memory_order_relaxed))
+                    break;
+
+                node = hazard.protect(m_head);
+            }
+
+            return node;
+        }
+
+        /**
+        \fn LockFreeStack<T>::NodeCache::NodeCache(CacheState& state)
+        \brief Creates empty cache and marks \a state alive.
+        **/
+        template <typename T>
+        LockFreeStack<T>::NodeCache::NodeCache(CacheState& state)
+            : m_count(0),
+            m_state(state)
+        {
+            m_state = CacheState::Alive;
+        }
+
+        /**
+        \fn LockFreeStack<T>::NodeCache::~NodeCache()
+        \brief Frees the cached nodes and marks the cache destroyed.
+        **/
+        template <typename T>
+        LockFreeStack<T>::NodeCache::~NodeCache()
+        {
+            while (m_count > 0)
+                ::operator delete(m_blocks[--m_count]);
+
+            m_state = CacheState::Destroyed;
+        }
+
+        /**
+        \fn LockFreeStack<T>::NodeCache* LockFreeStack<T>::GetNodeCache(bool create)
+        \brief Returns node cache of the calling thread.
+
+        Returns nullptr once the cache has been destroyed at thread exit,
+        when retired nodes may still be reclaimed, or if it does not exist
+        yet and \a create is not set.
+        **/
+        template <typename T>
+        typename LockFreeStack<T>::NodeCache* LockFreeStack<T>::GetNodeCache(bool create)
+        {
+            //Trivially destructible, so it outlives t_cache
+            static thread_local CacheState t_state = CacheState::Unused;
+            if (t_state == CacheState::Destroyed || (t_state == CacheState::Unused && !create))
+                return nullptr;
+
+            static thread_local NodeCache t_cache(t_state);
+            return &t_cache;
+        }
+
+        /**
+        \fn LockFreeStack<T>::Node* LockFreeStack<T>::CreateNode(T&& value, Node* next)
+        \brief Creates node in a cached block, allocating only when the cache is empty.
+        **/
+        template <typename T>
+        typename LockFreeStack<T>::Node* LockFreeStack<T>::CreateNode(T&& value, Node* next)
+        {
+            NodeCache* cache = GetNodeCache(true);
+
+            void* block = nullptr;
+            if (cache && cache->m_count > 0)
+                block = cache->m_blocks[--cache->m_count];
+            else
+                block = ::operator new(sizeof(Node));
+
+            try
+            {
+                return new (block) Node{ std::move(value), next };
+            }
+            catch (...)
+            {
+                ::operator delete(block);
+                throw;
+            }
+        }
+
+        /**
+        \fn void LockFreeStack<T>::DestroyNode(void* node)
+        \brief Destroys \a node and keeps its block for reuse by the calling thread.
+        **/
+        template <typename T>
+        void LockFreeStack<T>::DestroyNode(void* node)
+        {
+            static_cast<Node*>(node)->~Node();
+
+            NodeCache* cache = GetNodeCache(false);
+            if (cache && cache->m_count < NodeCacheSize)
+                cache->m_blocks[cache->m_count++] = node;
+            else
+                ::operator delete(node);
+        }
+    }
+}
@@ -0,0 +1,314 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_mpmcqueue.h>
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \fn MPMCQueue<T>::MPMCQueue(size_t capacity)
+        \brief Creates empty queue holding up to \a capacity elements.
+
+        Capacity is rounded up to a power of two, and is at least two.
+        **/
+        template <typename T>
+        MPMCQueue<T>::MPMCQueue(size_t capacity)
+            : m_cells(),
+            m_mask(0),
+            m_enqueuePos(0),
+            m_dequeuePos(0),
+            m_waitingProducers(0),
+            m_waitingConsumers(0),
+            m_mutex(),
+            m_notFull(),
+            m_notEmpty()
+        {
+            size_t size = 2;
+            while (size < capacity)
+                size <<= 1;
+
+            m_cells.reset(new Cell[size]);
+            m_mask = size - 1;
+
+            for (size_t i = 0; i < size; i++)
+                m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+        }
+
+        /**
+        \fn MPMCQueue<T>::~MPMCQueue()
+        \brief Destroys any elements left in the queue.
+
+        No other thread may use the queue while it is destroyed.
+        **/
+        template <typename T>
+        MPMCQueue<T>::~MPMCQueue()
+        {
+            size_t end = m_enqueuePos.load(std::memory_order_relaxed);
+            for (size_t pos = m_dequeuePos.load(std::memory_order_relaxed); pos != end; pos++)
+                reinterpret_cast<T*>(&m_cells[pos & m_mask].m_storage)->~T();
+        }
+
+        /**
+        \fn bool MPMCQueue<T>::try_push(const T& _val)
+        \brief Copies \a _val into the queue unless it is full.
+        **/
+        template <typename T>
+        bool MPMCQueue<T>::try_push(const T& _val)
+        {
+            return Enqueue(_val);
+        }
+
+        /**
+        \fn bool MPMCQueue<T>::try_push(T&& _val)
+        \brief Moves \a _val into the queue unless it is full.
+
+        \a _val is left untouched if the queue was full.
+        **/
+        template <typename T>
+        bool MPMCQueue<T>::try_push(T&& _val)
+        {
+            return Enqueue(std::move(_val));
+        }
+
+        /**
+        \fn bool MPMCQueue<T>::try_pop(T& out)
+        \brief Moves oldest element into \a out unless the queue is empty.
+        **/
+        template <typename T>
+        bool MPMCQueue<T>::try_pop(T& out)
+        {
+            Cell* cell = nullptr;
+            size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                cell = &m_cells[pos & m_mask];
+                size_t sequence = cell->m_sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+
+                if (diff == 0)
+                {
+                    if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    //Cell has not been filled for this lap yet
+                    return false;
+                }
+                else
+                {
+                    pos = m_dequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            T* value = reinterpret_cast<T*>(&cell->m_storage);
+            out = std::move(*value);
+            value->~T();
+
+            //Hand the cell to the producer one lap ahead
+            cell->m_sequence.store(pos + m_mask + 1, std::memory_order_release);
+
+            NotifyProducers();
+            return true;
+        }
+
+        /**
+        \fn void MPMCQueue<T>::push(T _val)
+        \brief Adds \a _val to the queue, blocking while it is full.
+        **/
+        template <typename T>
+        void MPMCQueue<T>::push(T _val)
+        {
+            while (!Enqueue(std::move(_val)))
+            {
+                m_waitingProducers.fetch_add(1, std::memory_order_seq_cst);
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_notFull.wait(lock, [this] { return CanPush(); });
+                }
+                m_waitingProducers.fetch_sub(1, std::memory_order_seq_cst);
+            }
+        }
+
+        /**
+        \fn void MPMCQueue<T>::wait_pop(T& out)
+        \brief Moves oldest element into \a out, blocking while the queue is empty.
+        **/
+        template <typename T>
+        void MPMCQueue<T>::wait_pop(T& out)
+        {
+            while (!try_pop(out))
+            {
+                m_waitingConsumers.fetch_add(1, std::memory_order_seq_cst);
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_notEmpty.wait(lock, [this] { return CanPop(); });
+                }
+                m_waitingConsumers.fetch_sub(1, std::memory_order_seq_cst);
+            }
+        }
+
+        /**
+        \fn bool MPMCQueue<T>::empty() const
+        \brief Returns whether the queue held no elements when checked.
+        **/
+        template <typename T>
+        bool MPMCQueue<T>::empty() const
+        {
+            return !CanPop();
+        }
+
+        /**
+        \fn size_t MPMCQueue<T>::capacity() const
+        \brief Returns maximum number of elements the queue can hold.
+        **/
+        template <typename T>
+        size_t MPMCQueue<T>::capacity() const
+        {
+            return m_mask + 1;
+        }
+
+        /**
+        \fn bool MPMCQueue<T>::Enqueue(U&& value)
+        \brief Constructs element from \a value in the next free cell unless the queue is full.
+
+        A cell is only reserved once constructing the element can no longer
+        throw, since a reserved cell that is never published stalls every
+        consumer behind it.
+        **/
+        template <typename T>
+        template <class U>
+        bool MPMCQueue<T>::Enqueue(U&& value)
+        {
+            return Enqueue(std::forward<U>(value), std::is_nothrow_constructible<T, U&&>());
+        }
+
+        /**
+        \fn bool MPMCQueue<T>::Enqueue(U&& value, std::false_type)
+        \brief Constructs element before reserving a cell, then moves it in.
+        **/
+        template <typename T>
+        template <class U>
+        bool MPMCQueue<T>::Enqueue(U&& value, std::false_type)
+        {
+            static_assert(std::is_nothrow_move_constructible<T>::value,
+                "MPMCQueue<T> requires T to be nothrow move constructible");
+
+            T element(std::forward<U>(value));
+            return Enqueue(std::move(element), std::true_type());
+        }
+
+        /**
+        \fn bool MPMCQueue<T>::Enqueue(U&& value, std::true_type)
+        \brief Constructs element from \a value in place once a cell is reserved.
+        **/
+        template <typename T>
+        template <class U>
+        bool MPMCQueue<T>::Enqueue(U&& value, std::true_type)
+        {
+            Cell* cell = nullptr;
+            size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                cell = &m_cells[pos & m_mask];
+                size_t sequence = cell->m_sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+                if (diff == 0)
+                {
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    //Cell still holds the element from the previous lap
+                    return false;
+                }
+                else
+                {
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            new (&cell->m_storage) T(std::forward<U>(value));
+            cell->m_sequence.store(pos + 1, std::memory_order_release);
+
+            NotifyConsumers();
+            return true;
+        }
+
+        /**
+        \fn bool MPMCQueue<T>::CanPush() const
+        \brief Returns whether the next cell to fill is free.
+        **/
+        template <typename T>
+        bool MPMCQueue<T>::CanPush() const
+        {
+            size_t pos = m_enqueuePos.load(std::memory_order_seq_cst);
+            return m_cells[pos & m_mask].m_sequence.load(std::memory_order_seq_cst) == pos;
+        }
+
+        /**
+        \fn bool MPMCQueue<T>::CanPop() const
+        \brief Returns whether the next cell to read has been filled.
+        **/
+        template <typename T>
+        bool MPMCQueue<T>::CanPop() const
+        {
+            size_t pos = m_dequeuePos.load(std::memory_order_seq_cst);
+            return m_cells[pos & m_mask].m_sequence.load(std::memory_order_seq_cst) == pos + 1;
+        }
+
+        /**
+        \fn void MPMCQueue<T>::NotifyProducers()
+        \brief Wakes a producer blocked in push, if there is one.
+
+        The waiting count is checked after the cell was released and waiters
+        register before checking the cell, so a wakeup is never lost.
+        **/
+        template <typename T>
+        void MPMCQueue<T>::NotifyProducers()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_waitingProducers.load(std::memory_order_relaxed) == 0)
+                return;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+            }
+            m_notFull.notify_one();
+        }
+
+        /**
+        \fn void MPMCQueue<T>::NotifyConsumers()
+        \brief Wakes a consumer blocked in wait_pop, if there is one.
+        **/
+        template <typename T>
+        void MPMCQueue<T>::NotifyConsumers()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_waitingConsumers.load(std::memory_order_relaxed) == 0)
+                return;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+            }
+            m_notEmpty.notify_one();
+        }
+    }
+}
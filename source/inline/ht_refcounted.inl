@@ -7,52 +7,198 @@ namespace Hatchit
     namespace Core
     {
         /**
-        \fn Handle<VarType> RefCounted<VarType>::GetHandle<Args>(std::string ID, Args... args)
-        \brief Grabs handle to ref counted class from ID.
+        \fn Handle<VarType> RefCounted<VarType>::GetHandle<Args>(const std::string& name, Args... args)
+        \brief Grabs handle to ref counted class from name.
 
-        Gives handle to RefCounted instance based on given ID.  If a refcounted instance does not
-        currently exist for the given ID, one will be instantiated and a handle for it will return.
+        Gives handle to RefCounted instance based on given name.  If a refcounted instance does not
+        currently exist for the given name, one will be instantiated and a handle for it will return.
         If instantiation fails (no allocation or Initialize fails), an empty handle will be returned.
+
+        This is the slow path: every call locks the type's name table and
+        hashes \a name, see GetIDFromName.  Code calling it every frame
+        should keep the ID and use GetHandle(const Guid&) instead.
+        **/
+        template<typename VarType>
+        template<typename... Args>
+        inline Handle<VarType> RefCounted<VarType>::GetHandle(const std::string& name, Args&&... args)
+        {
+            return GetHandle(GetIDFromName(name), std::forward<Args>(args)...);
+        }
+
+        /**
+        \fn Handle<VarType> RefCounted<VarType>::GetHandle<Args>(const Guid& ID, Args... args)
+        \brief Grabs handle to ref counted class from ID.
+
+        Like GetHandle(name), but takes the ID as is, i.e. one returned by
+        GetIDFromName.  Does not allocate if the instance exists.  IDs from
+        _guid literals are hashed at compile time but, unlike GetIDFromName,
+        do not depend on the type, so they refer to other resources than
+        the same name passed as a string.  If a resource of another type is
+        stored under \a ID, an empty handle is returned.
         **/
         template<typename VarType>
         template<typename... Args>
-        inline Handle<VarType> RefCounted<VarType>::GetHandle(std::string name, Args&&... args)
+        inline Handle<VarType> RefCounted<VarType>::GetHandle(const Guid& ID, Args&&... args)
         {
-            name += std::to_string(typeid(VarType).hash_code());
-            Guid ID = Guid::FromString(name);
-            VarType* var = RefCountedResourceManager::GetRawPointer<VarType, Args...>(std::move(ID), std::forward<Args>(args)...);
+            VarType* var = RefCountedResourceManager::GetRawPointer<VarType, Args...>(ID, std::forward<Args>(args)...);
             if (var)
-                return Handle<VarType>(var, &(var->m_refCount), &(var->m_ID));
+                return Handle<VarType>(var, var, false);
             else
                 return Handle<VarType>();
         }
 
+        /**
+        \fn Handle<VarType> RefCounted<VarType>::GetHandle(const SlotHandle& slot)
+        \brief Grabs handle to ref counted class from its SlotHandle.
+
+        Returns an invalid handle if the resource was released.  Only
+        resources of types opted into UseSlotMap<T> have SlotHandles.
+        **/
         template<typename VarType>
-        template<typename ...Args>
-        inline Handle<VarType> RefCounted<VarType>::GetHandleAsync(Handle<VarType> _default, std::string name, Args&&... args)
+        inline Handle<VarType> RefCounted<VarType>::GetHandle(const SlotHandle& slot)
         {
-            name += std::to_string(typeid(VarType).hash_code());
-            Guid ID = Guid::FromString(name);
-            VarType* var = RefCountedResourceManager::GetRawPointerUnitialized<VarType, Args...>(std::move(ID), std::forward<Args>(args)...);
+            VarType* var = RefCountedResourceManager::GetRawPointerFromSlot<VarType>(slot);
             if (var)
+                return Handle<VarType>(var, var, false);
+            else
+                return Handle<VarType>();
+        }
+
+        /**
+        \fn Handle<VarType> RefCounted<VarType>::GetHandleAsync<Args>(Handle<VarType> _default, const std::string& name, Args... args)
+        \brief Grabs handle to ref counted class from name, loading it on a Background job.
+
+        See GetHandleAsync(_default, ID, args).  Like GetHandle(name), it
+        looks the name up on every call.
+        **/
+        template<typename VarType>
+        template<typename ...Args>
+        inline Handle<VarType> RefCounted<VarType>::GetHandleAsync(Handle<VarType> _default, const std::string& name, Args&&... args)
+        {
+            return GetHandleAsync(std::move(_default), GetIDFromName(name), std::forward<Args>(args)...);
+        }
+
+        /**
+        \fn Handle<VarType> RefCounted<VarType>::GetHandleAsync<Args>(Handle<VarType> _default, const Guid& ID, Args... args)
+        \brief Grabs handle to ref counted class from ID, loading it on a Background job.
+
+        Returns at once.  The handle points at the placeholder \a _default
+        until InitializeAsync has succeeded on a Scheduler job, then at the
+        resource; every copy of the handle switches over.  Concurrent
+        requests for the same ID share one resource and one load.  If
+        loading fails, handles keep pointing at the placeholder.  The load
+        job can be waited on through Handle<T>::GetLoadJob.  Arguments are
+        copied into the job.
+        **/
+        template<typename VarType>
+        template<typename ...Args>
+        inline Handle<VarType> RefCounted<VarType>::GetHandleAsync(Handle<VarType> _default, const Guid& ID, Args&&... args)
+        {
+            VarType* var = RefCountedResourceManager::GetRawPointerUnitialized<VarType>(ID);
+            if (!var)
+                return Handle<VarType>();
+
+            Handle<VarType> handle(_default.m_ptr, var, false);
+
+            uint32_t state;
+            if (var->TryScheduleLoad(state))
+            {
+                JobHandle job = Scheduler::ScheduleJob(JobPriority::Background,
+                    &RefCounted<VarType>::template LoadAsync<typename std::decay<Args>::type...>,
+                    handle, _default, std::forward<Args>(args)...);
+
+                var->PublishLoadJob(std::move(job));
+            }
+            else if (state & LoadFailed)
             {
-                Handle<VarType> handle(_default.m_ptr, &(var->m_refCount), &(var->m_ID));
-                if (!var->InitializeAsync(handle, _default, std::forward<Args>(args)...))
-                {
-                    delete var;
-                    RefCountedResourceManager::ReleaseRawPointer<VarType>(ID);
-                }
-
-                return handle;
+                return _default;
             }
 
-            return Handle<VarType>();
+            return handle;
+        }
+
+        /**
+        \fn void RefCounted<VarType>::LoadAsync<Args>(Handle<VarType> handle, Handle<VarType> _default, Args... args)
+        \brief Job body of GetHandleAsync.  Initializes the resource and publishes the result.
+        **/
+        template<typename VarType>
+        template<typename ...Args>
+        inline void RefCounted<VarType>::LoadAsync(Handle<VarType> handle, Handle<VarType> _default, Args... args)
+        {
+            VarType* var = static_cast<VarType*>(handle.m_counted);
+            var->CompleteLoad(var->InitializeAsync(handle, _default, std::move(args)...));
+        }
+
+        /**
+        \fn const Guid& RefCounted<VarType>::GetIDFromName(const std::string& name)
+        \brief Returns ID resources of type VarType with given name are stored under.
+
+        The name is combined with the type, so two different types can use
+        the same name.  The ID is computed on the first call for each name
+        and interned; later calls only look it up, but still lock the name
+        table and hash \a name.  The returned reference stays valid for the
+        lifetime of the process, so callers may keep it instead of looking
+        the name up again.
+        **/
+        template<typename VarType>
+        inline const Guid& RefCounted<VarType>::GetIDFromName(const std::string& name)
+        {
+            NameTable& table = GetNameTable();
+            std::lock_guard<std::mutex> lock(table.m_mutex);
+
+            std::unordered_map<std::string, Guid>::iterator it = table.m_IDs.find(name);
+            if (it != table.m_IDs.end())
+                return it->second;
+
+            Guid ID = Guid::FromString(name + std::to_string(typeid(VarType).hash_code()));
+            return table.m_IDs.emplace(name, std::move(ID)).first->second;
+        }
+
+        /**
+        \fn RefCounted<VarType>::NameTable& RefCounted<VarType>::GetNameTable()
+        \brief Returns interned IDs of type VarType.
+
+        Allocated once and never destroyed, so IDs may be looked up during
+        any thread or process shutdown.
+        **/
+        template<typename VarType>
+        inline typename RefCounted<VarType>::NameTable& RefCounted<VarType>::GetNameTable()
+        {
+            static NameTable* _instance = new NameTable();
+            return *_instance;
+        }
+
+        /**
+        \fn void* RefCounted<T>::operator new(size_t size)
+        \brief Allocates resource from SlabPool<T> if T opted in via UseSlabPool<T>.
+
+        Types derived from T with a different size use the global heap.
+        **/
+        template<typename VarType>
+        inline void* RefCounted<VarType>::operator new(size_t size)
+        {
+            if (UseSlabPool<VarType>::value && size == sizeof(VarType))
+                return SlabPool<VarType>::Allocate();
+
+            return ::operator new(size);
+        }
+
+        /**
+        \fn void RefCounted<T>::operator delete(void* block, size_t size)
+        \brief Frees resource allocated by RefCounted<T>::operator new.
+        **/
+        template<typename VarType>
+        inline void RefCounted<VarType>::operator delete(void* block, size_t size)
+        {
+            if (UseSlabPool<VarType>::value && size == sizeof(VarType))
+                SlabPool<VarType>::Free(block);
+            else
+                ::operator delete(block);
         }
 
         template<typename VarType>
         inline RefCounted<VarType>::RefCounted(Guid ID)
-            :   m_refCount(0U),
-                m_ID(std::move(ID))
+            :   RefCountedBase(std::move(ID))
         {
 
         }
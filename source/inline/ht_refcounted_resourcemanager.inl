@@ -13,7 +13,8 @@ namespace Hatchit
         storing RefCounted objects
         **/
         inline RefCountedResourceManager::RefCountedResourceManager()
-            : m_resources() {}
+            : m_shards(),
+            m_deferredRelease(false) {}
 
         /**
         \fn RefCountedResourceManager::~RefCountedResourceManager()
@@ -25,9 +26,9 @@ namespace Hatchit
         **/
         inline RefCountedResourceManager::~RefCountedResourceManager()
         {
-            if(m_resources.size() > 0)
+            for (Shard& shard : m_shards)
             {
-                for (auto resource : m_resources)
+                for (auto resource : shard.m_resources)
                 {
                     HT_ERROR_PRINTF("Resource Alive: %s\n", resource.first.GetOriginalString());
                 }
@@ -46,6 +47,16 @@ namespace Hatchit
         is found with ID, one is created and initialized with given
         arguments.  Then it is stored inside RefCountedResourceManager for
         later accessibility.
+
+        Initialization runs without holding any lock.  If another thread
+        stored a resource with the same ID in the meantime, the new resource
+        is discarded and the stored one is returned.
+
+        A stored resource still being loaded by GetHandleAsync is waited
+        for.  If its load failed, nullptr is returned.
+
+        The returned resource carries one reference, taken while its shard
+        was locked, which the caller adopts.
         **/
         template<typename ResourceType, typename... Args>
         inline ResourceType* RefCountedResourceManager::GetRawPointer(const Guid& ID, Args&&... arguments)
@@ -56,42 +67,50 @@ namespace Hatchit
             //Create a typed name so two different types can use the same name
             //name += std::to_string(typeid(ResourceType).hash_code());
 
-            RefCountedResourceManager& _instance = RefCountedResourceManager::GetInstance();
+            Shard& shard = GetShard(ID);
+
+            ResourceType* existing = Find<ResourceType>(shard, ID);
+            if (existing)
+                return WaitForLoad(existing);
 
-            std::map<Guid, void*>::iterator it = _instance.m_resources.find(ID);
-            if (it == _instance.m_resources.end())
+            //resource not found.  Must allocate
+            ResourceType* resource = new ResourceType(ID);
+            if (!resource->Initialize(std::forward<Args>(arguments)...))
             {
-                //resource not found.  Must allocate
-                ResourceType* resource = new ResourceType(ID);
-                if (!resource->Initialize(std::forward<Args>(arguments)...))
-                {
-                    delete resource;
-                    return nullptr;
-                }
-                _instance.m_resources.insert(std::make_pair(ID, resource));
+                delete resource;
+                return nullptr;
             }
 
-            return reinterpret_cast<ResourceType*>(_instance.m_resources[ID]);
+            resource->CompleteLoad(true);
+
+            return WaitForLoad(Insert(shard, ID, resource));
         }
 
+        /**
+        \fn template<typename T, typename... Args>
+            T* RefCountedResourceManager::GetRawPointerUnitialized<T, Args>(
+            const Guid& ID,
+            Args&&... arguments)
+        \brief Grabs raw pointer associated with ID without initializing it.
+
+        Like GetRawPointer, but a newly created resource is stored without
+        being initialized.  The returned resource carries one reference which
+        the caller adopts.
+        **/
         template<typename ResourceType, typename ...Args>
         inline ResourceType * RefCountedResourceManager::GetRawPointerUnitialized(const Guid & ID, Args && ...arguments)
         {
             if (ID == Guid::GetEmpty())
                 return nullptr;
 
-            RefCountedResourceManager& _instance = RefCountedResourceManager::GetInstance();
+            Shard& shard = GetShard(ID);
 
-            std::map<Guid, void*>::iterator it = _instance.m_resources.find(ID);
-            if (it == _instance.m_resources.end())
-            {
-                //resource not found.  Must allocate
-                ResourceType* resource = new ResourceType(ID);
-               
-                _instance.m_resources.insert(std::make_pair(ID, resource));
-            }
+            ResourceType* existing = Find<ResourceType>(shard, ID);
+            if (existing)
+                return existing;
 
-            return reinterpret_cast<ResourceType*>(_instance.m_resources[ID]);
+            //resource not found.  Must allocate
+            return Insert(shard, ID, new ResourceType(ID));
         }
 
         /**
@@ -101,20 +120,242 @@ namespace Hatchit
         \brief Releases raw pointer stored inside ResourceManager with given ID
 
         Releases raw pointer stored inside ResourceManager with given ID.
-        Destructor called is synonymous with T.
+        The resource is destroyed through its virtual destructor, so T may be
+        any type a handle to it was cast to.  See Release.
         **/
         template<typename ResourceType>
         inline void RefCountedResourceManager::ReleaseRawPointer(const Guid& ID)
         {
-            RefCountedResourceManager& _instance = RefCountedResourceManager::GetInstance();
+            Release(ID);
+        }
+
+        /**
+        \fn template<typename T>
+            T* RefCountedResourceManager::Find<T>(Shard& shard, const Guid& ID)
+        \brief Returns resource stored in \a shard with given ID, or nullptr.
+
+        Adds a reference to the resource before unlocking, so it cannot be
+        released in between.  A resource stored as another type is not
+        returned, see Insert.
+        **/
+        template<typename ResourceType>
+        inline ResourceType* RefCountedResourceManager::Find(Shard& shard, const Guid& ID)
+        {
+            std::lock_guard<std::mutex> lock(shard.m_mutex);
+
+            std::unordered_map<Guid, RefCountedBase*>::iterator it = shard.m_resources.find(ID);
+            if (it == shard.m_resources.end())
+                return nullptr;
+
+            RefCountedBase* resource = it->second;
+            if (*resource->m_type != typeid(ResourceType))
+                return nullptr;
+
+            resource->AddReference();
+
+            return static_cast<ResourceType*>(resource);
+        }
+
+        /**
+        \fn template<typename T>
+            T* RefCountedResourceManager::Insert<T>(Shard& shard, const Guid& ID, T* resource)
+        \brief Stores \a resource in \a shard unless a resource with given ID already exists.
+
+        Returns the stored resource with a reference added.  If another
+        thread stored one first, \a resource is deleted and theirs is
+        returned instead.  If a resource of another type is stored under
+        \a ID, \a resource is deleted and nullptr is returned.
+        **/
+        template<typename ResourceType>
+        inline ResourceType* RefCountedResourceManager::Insert(Shard& shard, const Guid& ID, ResourceType* resource)
+        {
+            resource->m_type = &typeid(ResourceType);
+
+            RefCountedBase* stored = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(shard.m_mutex);
+                std::pair<std::unordered_map<Guid, RefCountedBase*>::iterator, bool> result = shard.m_resources.emplace(ID, resource);
+                if (result.second)
+                    AddSlot(resource);
+
+                stored = result.first->second;
+                if (*stored->m_type == typeid(ResourceType))
+                    stored->AddReference();
+                else
+                    stored = nullptr;
+            }
+
+            if (stored != resource)
+                delete resource;
+
+            if (!stored)
+                HT_ERROR_PRINTF("RefCountedResourceManager: %s is stored as another type\n", ID.GetOriginalString().c_str());
+
+            return static_cast<ResourceType*>(stored);
+        }
+
+        /**
+        \fn template<typename T>
+            T* RefCountedResourceManager::WaitForLoad<T>(T* resource)
+        \brief Waits until \a resource has been loaded asynchronously, if it is being loaded.
+
+        Returns \a resource, or nullptr after dropping the caller's reference
+        if its load failed.  Passes nullptr through.
+        **/
+        template<typename ResourceType>
+        inline ResourceType* RefCountedResourceManager::WaitForLoad(ResourceType* resource)
+        {
+            if (!resource)
+                return nullptr;
+
+            uint32_t state = resource->m_loadState.load(std::memory_order_acquire);
+            if (!(state & RefCountedBase::LoadScheduled))
+                return resource;
 
-            std::map<Guid, void*>::iterator it = _instance.m_resources.find(ID);
-            if (it != _instance.m_resources.end())
+            if (!(state & (RefCountedBase::Loaded | RefCountedBase::LoadFailed)))
             {
-                delete (reinterpret_cast<ResourceType*>(_instance.m_resources[ID]));
+                Scheduler::WaitFor(resource->GetLoadJob());
+                state = resource->m_loadState.load(std::memory_order_acquire);
+            }
 
-                _instance.m_resources.erase(it);
+            //The load job ran, so the resource failed to load unless it is marked loaded
+            if (!(state & RefCountedBase::Loaded))
+            {
+                if (resource->RemoveReference())
+                    Release(resource->GetID());
+                return nullptr;
             }
+
+            return resource;
+        }
+
+        /**
+        \fn template<typename T>
+            T* RefCountedResourceManager::GetRawPointerFromSlot<T>(const SlotHandle& slot)
+        \brief Returns resource registered under \a slot, or nullptr if it was released.
+
+        Like GetRawPointer, the returned resource carries one reference which
+        the caller adopts.  Requires UseSlotMap<T>.
+        **/
+        template<typename ResourceType>
+        inline ResourceType* RefCountedResourceManager::GetRawPointerFromSlot(const SlotHandle& slot)
+        {
+            static_assert(UseSlotMap<ResourceType>::value, "Resource type is not stored in a SlotMap");
+
+            TypeSlots<ResourceType>& slots = GetTypeSlots<ResourceType>();
+            std::lock_guard<std::mutex> lock(slots.m_mutex);
+
+            ResourceType** resource = slots.m_resources.get(slot);
+            if (!resource)
+                return nullptr;
+
+            //A resource without references is being released, or waits for FlushReleases
+            if (!(*resource)->TryAddReference())
+                return nullptr;
+
+            return *resource;
+        }
+
+        /**
+        \fn template<typename T, typename Func>
+            void RefCountedResourceManager::ForEachResource<T, Func>(Func&& function)
+        \brief Calls \a function with every live resource of type T.
+
+        Resources are visited densely, in no particular order.  A reference
+        is taken to each live resource while the type's SlotMap is locked,
+        and \a function is called after unlocking, so it may acquire and
+        release resources.  Resources stored after the SlotMap was unlocked
+        are not visited.  Requires UseSlotMap<T>.
+        **/
+        template<typename ResourceType, typename Func>
+        inline void RefCountedResourceManager::ForEachResource(Func&& function)
+        {
+            static_assert(UseSlotMap<ResourceType>::value, "Resource type is not stored in a SlotMap");
+
+            std::vector<ResourceType*> resources;
+            {
+                TypeSlots<ResourceType>& slots = GetTypeSlots<ResourceType>();
+                std::lock_guard<std::mutex> lock(slots.m_mutex);
+
+                resources.reserve(slots.m_resources.size());
+                for (ResourceType* resource : slots.m_resources)
+                {
+                    //A resource without references is being released, or waits for FlushReleases
+                    if (resource->TryAddReference())
+                        resources.push_back(resource);
+                }
+            }
+
+            size_t visited = 0;
+            try
+            {
+                for (; visited < resources.size(); visited++)
+                    function(*resources[visited]);
+            }
+            catch (...)
+            {
+                for (ResourceType* resource : resources)
+                {
+                    if (resource->RemoveReference())
+                        Release(resource->GetID());
+                }
+                throw;
+            }
+
+            for (ResourceType* resource : resources)
+            {
+                if (resource->RemoveReference())
+                    Release(resource->GetID());
+            }
+        }
+
+        /**
+        \fn template<typename T>
+            RefCountedResourceManager::TypeSlots<T>& RefCountedResourceManager::GetTypeSlots<T>()
+        \brief Returns SlotMap of resource type T.
+
+        Allocated once and never destroyed, so resources may be released
+        during any thread or process shutdown.
+        **/
+        template<typename ResourceType>
+        inline RefCountedResourceManager::TypeSlots<ResourceType>& RefCountedResourceManager::GetTypeSlots()
+        {
+            static TypeSlots<ResourceType>* _instance = new TypeSlots<ResourceType>();
+            return *_instance;
+        }
+
+        /**
+        \fn template<typename T>
+            void RefCountedResourceManager::AddSlot<T>(T* resource)
+        \brief Registers newly stored \a resource in its type's SlotMap, if T opted in.
+
+        Called while the resource's shard is locked.  The resource remembers
+        how to remove itself, since it may be released through a handle of
+        another type.
+        **/
+        template<typename ResourceType>
+        inline void RefCountedResourceManager::AddSlot(ResourceType* resource)
+        {
+            if (!UseSlotMap<ResourceType>::value)
+                return;
+
+            TypeSlots<ResourceType>& slots = GetTypeSlots<ResourceType>();
+            std::lock_guard<std::mutex> lock(slots.m_mutex);
+            resource->m_slot = slots.m_resources.insert(resource);
+            resource->m_removeSlot = &EraseSlot<ResourceType>;
+        }
+
+        /**
+        \fn template<typename T>
+            void RefCountedResourceManager::EraseSlot<T>(RefCountedBase* resource)
+        \brief Removes \a resource, registered by AddSlot<T>, from the SlotMap of T.
+        **/
+        template<typename ResourceType>
+        inline void RefCountedResourceManager::EraseSlot(RefCountedBase* resource)
+        {
+            TypeSlots<ResourceType>& slots = GetTypeSlots<ResourceType>();
+            std::lock_guard<std::mutex> lock(slots.m_mutex);
+            slots.m_resources.erase(resource->m_slot);
         }
     }
-}
\ No newline at end of file
+}
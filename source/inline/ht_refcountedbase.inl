@@ -0,0 +1,201 @@
+#pragma once
+
+#include <ht_refcountedbase.h>
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \fn RefCountedBase::RefCountedBase()
+        \brief Creates unreferenced base with an empty ID.
+        **/
+        inline RefCountedBase::RefCountedBase()
+            : m_refCount(0U),
+            m_loadState(0U),
+            m_ID(),
+            m_slot(),
+            m_removeSlot(nullptr),
+            m_loadJob(),
+            m_type(nullptr)
+        {}
+
+        /**
+        \fn RefCountedBase::RefCountedBase(Guid ID)
+        \brief Creates unreferenced base identified by \a ID.
+        **/
+        inline RefCountedBase::RefCountedBase(Guid ID)
+            : m_refCount(0U),
+            m_loadState(0U),
+            m_ID(std::move(ID)),
+            m_slot(),
+            m_removeSlot(nullptr),
+            m_loadJob(),
+            m_type(nullptr)
+        {}
+
+        /**
+        \fn const Guid& RefCountedBase::GetID() const
+        \brief Returns ID the resource is stored under.
+        **/
+        inline const Guid& RefCountedBase::GetID() const
+        {
+            return m_ID;
+        }
+
+        /**
+        \fn const SlotHandle& RefCountedBase::GetSlot() const
+        \brief Returns SlotHandle the resource is registered under.
+
+        Only valid for types opted into UseSlotMap<T>.
+        **/
+        inline const SlotHandle& RefCountedBase::GetSlot() const
+        {
+            return m_slot;
+        }
+
+        /**
+        \fn void RefCountedBase::AddReference()
+        \brief Increments reference count.
+
+        A new reference is always taken from an existing one, or under the
+        resource manager's lock, so no ordering is needed.
+        **/
+        inline void RefCountedBase::AddReference()
+        {
+            m_refCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+        \fn bool RefCountedBase::RemoveReference()
+        \brief Decrements reference count unless this is the last reference.
+
+        Returns true, leaving the count untouched, if the caller holds the
+        last reference.  The caller must then hand it to
+        RefCountedResourceManager::ReleaseRawPointer, which drops it while
+        the resource can no longer be found.  Otherwise the decrement
+        publishes every write made through this reference to the thread
+        which eventually releases the resource.
+        **/
+        inline bool RefCountedBase::RemoveReference()
+        {
+            uint32_t count = m_refCount.load(std::memory_order_relaxed);
+            while (count > 1)
+            {
+                if (m_refCount.compare_exchange_weak(count, count - 1,
+                    std::memory_order_release, std::memory_order_relaxed))
+                    return false;
+            }
+
+            return true;
+        }
+
+        /**
+        \fn bool RefCountedBase::TryAddReference()
+        \brief Increments reference count unless it already reached zero.
+
+        Used by RefCountedResourceManager to reference a resource found
+        through its SlotHandle without locking its shard.
+        **/
+        inline bool RefCountedBase::TryAddReference()
+        {
+            uint32_t count = m_refCount.load(std::memory_order_relaxed);
+            while (count != 0)
+            {
+                if (m_refCount.compare_exchange_weak(count, count + 1, std::memory_order_relaxed))
+                    return true;
+            }
+
+            return false;
+        }
+
+        /**
+        \fn bool RefCountedBase::RemoveLastReference()
+        \brief Decrements reference count, returning whether it reached zero.
+
+        Used by RefCountedResourceManager while the resource's shard is
+        locked.  Acquires every write published by earlier decrements.
+        **/
+        inline bool RefCountedBase::RemoveLastReference()
+        {
+            return m_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        }
+
+        /**
+        \fn uint32_t RefCountedBase::GetReferenceCount() const
+        \brief Returns number of references at the time of the call.
+        **/
+        inline uint32_t RefCountedBase::GetReferenceCount() const
+        {
+            return m_refCount.load(std::memory_order_acquire);
+        }
+
+        /**
+        \fn bool RefCountedBase::IsLoaded() const
+        \brief Returns whether the resource finished initializing successfully.
+        **/
+        inline bool RefCountedBase::IsLoaded() const
+        {
+            return (m_loadState.load(std::memory_order_acquire) & Loaded) != 0;
+        }
+
+        /**
+        \fn JobHandle RefCountedBase::GetLoadJob() const
+        \brief Returns handle to the job loading the resource.
+
+        Pass it to Scheduler::WaitFor to wait until a resource requested
+        with GetHandleAsync has loaded.  Invalid unless the resource was
+        loaded asynchronously.
+        **/
+        inline JobHandle RefCountedBase::GetLoadJob() const
+        {
+            uint32_t state = m_loadState.load(std::memory_order_acquire);
+            if (!(state & LoadScheduled))
+                return JobHandle();
+
+            //The scheduling thread publishes the handle right after scheduling
+            while (!(state & LoadJobPublished))
+            {
+                std::this_thread::yield();
+                state = m_loadState.load(std::memory_order_acquire);
+            }
+
+            return m_loadJob;
+        }
+
+        /**
+        \fn bool RefCountedBase::TryScheduleLoad(uint32_t& state)
+        \brief Claims the right to load the resource asynchronously.
+
+        Only succeeds for the first caller on a resource which was never
+        initialized.  Otherwise \a state receives the current load state.
+        **/
+        inline bool RefCountedBase::TryScheduleLoad(uint32_t& state)
+        {
+            state = 0;
+            return m_loadState.compare_exchange_strong(state, LoadScheduled, std::memory_order_acq_rel);
+        }
+
+        /**
+        \fn void RefCountedBase::PublishLoadJob(JobHandle job)
+        \brief Stores handle to the job loading the resource.
+        **/
+        inline void RefCountedBase::PublishLoadJob(JobHandle job)
+        {
+            m_loadJob = std::move(job);
+            m_loadState.fetch_or(LoadJobPublished, std::memory_order_release);
+        }
+
+        /**
+        \fn void RefCountedBase::CompleteLoad(bool succeeded)
+        \brief Marks resource as loaded, or as failed to load.
+
+        Publishes every write made while initializing to threads which see
+        IsLoaded return true.
+        **/
+        inline void RefCountedBase::CompleteLoad(bool succeeded)
+        {
+            m_loadState.fetch_or(succeeded ? Loaded : LoadFailed, std::memory_order_release);
+        }
+    }
+}
@@ -7,16 +7,264 @@ namespace Hatchit
     namespace Core
     {
         /**
-        \fn void Scheduler::SchedulerJob(T&& function, U&&... arguments)
+        \fn Job::Job(Func&& function, JobHandle handle)
+        \brief Creates Threading job for given function
+
+        The function is moved into the job's inline storage when it fits.
+        The job signals \a handle once the function has returned.
+        **/
+        template<class Func>
+        inline Job::Job(Func&& function, JobHandle handle)
+            : m_callable(nullptr),
+            m_invoke(&Job::Invoke<typename std::decay<Func>::type>),
+            m_destroy(&Job::Destroy<typename std::decay<Func>::type>),
+            m_handle(std::move(handle))
+        {
+            using Callable = typename std::decay<Func>::type;
+            using Fits = std::integral_constant<bool,
+                sizeof(Callable) <= StorageSize && alignof(Callable) <= alignof(std::max_align_t)>;
+
+            Store<Callable>(std::forward<Func>(function), Fits());
+        }
+
+        template<class Callable, class Func>
+        inline void Job::Store(Func&& function, std::true_type)
+        {
+            m_callable = new (m_storage) Callable(std::forward<Func>(function));
+        }
+
+        template<class Callable, class Func>
+        inline void Job::Store(Func&& function, std::false_type)
+        {
+            m_callable = new Callable(std::forward<Func>(function));
+        }
+
+        template<class Func>
+        inline void Job::Invoke(void* callable)
+        {
+            (*static_cast<Func*>(callable))();
+        }
+
+        template<class Func>
+        inline void Job::Destroy(void* callable, bool inlined)
+        {
+            if (inlined)
+                static_cast<Func*>(callable)->~Func();
+            else
+                delete static_cast<Func*>(callable);
+        }
+
+        /**
+        \class Scheduler::BoundJob<Func, Args...>
+        \brief Owns a function and its arguments until the job runs.
+
+        Arguments are handed to the function as rvalues, since a job only
+        runs once.  This allows move-only arguments such as std::unique_ptr.
+        **/
+        template<class Func, class... Args>
+        class Scheduler::BoundJob
+        {
+        public:
+            template<class F, class... A>
+            explicit BoundJob(F&& function, A&&... arguments)
+                : m_function(std::forward<F>(function)),
+                m_arguments(std::forward<A>(arguments)...)
+            {}
+
+            void operator()()
+            {
+                Call(std::index_sequence_for<Args...>());
+            }
+
+        private:
+            template<size_t... Indices>
+            void Call(std::index_sequence<Indices...>)
+            {
+                m_function(std::move(std::get<Indices>(m_arguments))...);
+            }
+
+            Func                m_function;
+            std::tuple<Args...> m_arguments;
+        };
+
+        /**
+        \fn JobHandle Scheduler::ScheduleJob(T&& function, U&&... arguments)
         \brief Schedules job to be run in a threaded environment.
+
+        The function and arguments are moved or copied into the job, so
+        move-only callables and arguments are supported and nothing passed
+        in needs to outlive the call.  Returns handle which can be passed to
+        WaitFor to wait for the job to finish.  The job has Normal priority.
+        **/
+        template<class Func, class... Args, class>
+        inline JobHandle Scheduler::ScheduleJob(Func&& function, Args&&... arguments)
+        {
+            return ScheduleJob(JobPriority::Normal, std::forward<Func>(function), std::forward<Args>(arguments)...);
+        }
+
+        /**
+        \fn JobHandle Scheduler::ScheduleJob(JobPriority priority, T&& function, U&&... arguments)
+        \brief Schedules job with given \a priority to be run in a threaded environment.
         **/
         template<class Func, class... Args>
-        inline void Scheduler::ScheduleJob(Func&& function, Args&&... arguments)
+        inline JobHandle Scheduler::ScheduleJob(JobPriority priority, Func&& function, Args&&... arguments)
         {
-            IJob* job = new Job([&, arguments...]() { function(arguments...); ThreadEnded();  });
+            using Bound = BoundJob<typename std::decay<Func>::type, typename std::decay<Args>::type...>;
+
+            JobHandle handle = CreateHandle();
+            IJob* job = new Job(Bound(std::forward<Func>(function), std::forward<Args>(arguments)...), handle);
 
-            AddJob(job);
+            AddJob(job, priority);
+
+            return handle;
+        }
+
+        /**
+        \fn void Scheduler::ParallelFor(size_t begin, size_t end, size_t grainSize, Func&& function)
+        \brief Calls \a function for every index in [begin, end) across the workers.
+
+        The range is split lazily: a worker only halves its remaining range
+        while nobody else has work to steal from it, and never below
+        \a grainSize indices.  Idle workers steal the split off halves.  When
+        called from outside the pool, the range is handed to a worker and the
+        caller helps by running stolen pieces without splitting them further.
+        A grain size of zero picks one based on the number of workers.
+        Returns once every index has been processed.
+        **/
+        template<class Func>
+        inline void Scheduler::ParallelFor(size_t begin, size_t end, size_t grainSize, Func&& function)
+        {
+            if (begin >= end)
+                return;
+
+            grainSize = ResolveGrainSize(end - begin, grainSize);
+            if (IsWorkerThread())
+            {
+                ParallelForRange(begin, end, grainSize, function);
+                return;
+            }
+
+            WaitFor(SpawnJob([begin, end, grainSize, &function]() {
+                ParallelForRange(begin, end, grainSize, function);
+            }));
+        }
+
+        /**
+        \fn T Scheduler::ParallelReduce(size_t begin, size_t end, size_t grainSize, T identity, Func&& function, Reduce&& reduce)
+        \brief Combines \a function of every index in [begin, end) using \a reduce.
+
+        Splits the range like ParallelFor.  Each piece folds function(index)
+        into an accumulator starting at \a identity, and pieces are combined
+        in index order with reduce(left, right).  \a reduce must be
+        associative, and T must be default constructible and copyable.
+        **/
+        template<class T, class Func, class Reduce>
+        inline T Scheduler::ParallelReduce(size_t begin, size_t end, size_t grainSize, T identity, Func&& function, Reduce&& reduce)
+        {
+            if (begin >= end)
+                return identity;
+
+            grainSize = ResolveGrainSize(end - begin, grainSize);
+            if (IsWorkerThread())
+                return ParallelReduceRange(begin, end, grainSize, identity, function, reduce);
+
+            T result = identity;
+            WaitFor(SpawnJob([begin, end, grainSize, &result, &identity, &function, &reduce]() {
+                result = ParallelReduceRange(begin, end, grainSize, identity, function, reduce);
+            }));
+
+            return result;
+        }
+
+        /**
+        \fn JobHandle Scheduler::SpawnJob(Func&& function)
+        \brief Creates job for \a function and releases it to the workers immediately.
+
+        The job inherits the priority of the job running on the calling thread.
+        **/
+        template<class Func>
+        inline JobHandle Scheduler::SpawnJob(Func&& function)
+        {
+            return SpawnJob(GetCurrentPriority(), std::forward<Func>(function));
+        }
+
+        /**
+        \fn JobHandle Scheduler::SpawnJob(JobPriority priority, Func&& function)
+        \brief Creates job for \a function with \a priority and releases it to the workers immediately.
+        **/
+        template<class Func>
+        inline JobHandle Scheduler::SpawnJob(JobPriority priority, Func&& function)
+        {
+            JobHandle handle = CreateHandle();
+            ReleaseJob(new Job(std::forward<Func>(function), handle), priority);
+
+            return handle;
+        }
+
+        template<class Func>
+        inline void Scheduler::ParallelForRange(size_t begin, size_t end, size_t grainSize, Func& function)
+        {
+            //Every split halves the range, so there can be no more splits than bits
+            JobHandle spawned[sizeof(size_t) * 8];
+            size_t spawnCount = 0;
+
+            while (begin < end)
+            {
+                if (end - begin > grainSize && ShouldSplit())
+                {
+                    size_t middle = begin + (end - begin) / 2;
+                    spawned[spawnCount++] = SpawnJob([middle, end, grainSize, &function]() {
+                        ParallelForRange(middle, end, grainSize, function);
+                    });
+                    end = middle;
+                    continue;
+                }
+
+                size_t chunkEnd = end - begin > grainSize ? begin + grainSize : end;
+                for (size_t index = begin; index < chunkEnd; index++)
+                    function(index);
+                begin = chunkEnd;
+            }
+
+            for (size_t i = 0; i < spawnCount; i++)
+                WaitFor(spawned[i]);
+        }
+
+        template<class T, class Func, class Reduce>
+        inline T Scheduler::ParallelReduceRange(size_t begin, size_t end, size_t grainSize, const T& identity, Func& function, Reduce& reduce)
+        {
+            JobHandle spawned[sizeof(size_t) * 8];
+            T results[sizeof(size_t) * 8];
+            size_t spawnCount = 0;
+
+            T accumulator = identity;
+            while (begin < end)
+            {
+                if (end - begin > grainSize && ShouldSplit())
+                {
+                    size_t middle = begin + (end - begin) / 2;
+                    T* result = &results[spawnCount];
+                    spawned[spawnCount++] = SpawnJob([middle, end, grainSize, result, &identity, &function, &reduce]() {
+                        *result = ParallelReduceRange(middle, end, grainSize, identity, function, reduce);
+                    });
+                    end = middle;
+                    continue;
+                }
+
+                size_t chunkEnd = end - begin > grainSize ? begin + grainSize : end;
+                for (size_t index = begin; index < chunkEnd; index++)
+                    accumulator = reduce(accumulator, function(index));
+                begin = chunkEnd;
+            }
+
+            //Later spawns cover ranges closer to our own, so fold them in first
+            for (size_t i = spawnCount; i > 0; i--)
+            {
+                WaitFor(spawned[i - 1]);
+                accumulator = reduce(accumulator, results[i - 1]);
+            }
+
+            return accumulator;
         }
     }
 }
-
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <ht_slabpool.h>
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \fn void* SlabPool<T>::Allocate()
+        \brief Returns uninitialized block large enough for one T.
+        **/
+        template<typename T>
+        inline void* SlabPool<T>::Allocate()
+        {
+            static_assert(alignof(T) <= alignof(std::max_align_t),
+                "SlabPool does not support over-aligned types");
+
+            Pool& pool = GetPool();
+            std::lock_guard<std::mutex> lock(pool.m_mutex);
+
+            if (!pool.m_free)
+            {
+                //Thread every slot of a new slab onto the free list
+                Slot* slab = static_cast<Slot*>(::operator new(sizeof(Slot) * ObjectsPerSlab));
+                for (size_t i = 0; i < ObjectsPerSlab - 1; i++)
+                    slab[i].m_next = &slab[i + 1];
+                slab[ObjectsPerSlab - 1].m_next = nullptr;
+
+                pool.m_slabs.push_back(slab);
+                pool.m_free = slab;
+            }
+
+            Slot* slot = pool.m_free;
+            pool.m_free = slot->m_next;
+
+            return slot;
+        }
+
+        /**
+        \fn void SlabPool<T>::Free(void* block)
+        \brief Returns \a block obtained from Allocate to the pool.
+        **/
+        template<typename T>
+        inline void SlabPool<T>::Free(void* block)
+        {
+            if (!block)
+                return;
+
+            Pool& pool = GetPool();
+            std::lock_guard<std::mutex> lock(pool.m_mutex);
+
+            Slot* slot = static_cast<Slot*>(block);
+            slot->m_next = pool.m_free;
+            pool.m_free = slot;
+        }
+
+        /**
+        \fn SlabPool<T>::Pool& SlabPool<T>::GetPool()
+        \brief Returns pool of type T.
+
+        Allocated once and never destroyed, so resources may be freed
+        during any thread or process shutdown.
+        **/
+        template<typename T>
+        inline typename SlabPool<T>::Pool& SlabPool<T>::GetPool()
+        {
+            static Pool* _instance = new Pool();
+            return *_instance;
+        }
+    }
+}
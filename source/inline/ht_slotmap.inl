@@ -0,0 +1,211 @@
+#pragma once
+
+#include <ht_slotmap.h>
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        template<typename T>
+        inline SlotMap<T>::SlotMap()
+            : m_values(),
+            m_valueSlots(),
+            m_slots(),
+            m_freeHead(NoSlot)
+        {}
+
+        /**
+        \fn SlotHandle SlotMap<T>::insert(const T& _val)
+        \brief Appends copy of \a _val and returns handle to it.
+        **/
+        template<typename T>
+        inline SlotHandle SlotMap<T>::insert(const T& _val)
+        {
+            return emplace(_val);
+        }
+
+        /**
+        \fn SlotHandle SlotMap<T>::insert(T&& _val)
+        \brief Appends \a _val and returns handle to it.
+        **/
+        template<typename T>
+        inline SlotHandle SlotMap<T>::insert(T&& _val)
+        {
+            return emplace(std::move(_val));
+        }
+
+        /**
+        \fn SlotHandle SlotMap<T>::emplace(Args&&... arguments)
+        \brief Constructs element from \a arguments and returns handle to it.
+        **/
+        template<typename T>
+        template <class... Args>
+        inline SlotHandle SlotMap<T>::emplace(Args&&... arguments)
+        {
+            m_values.emplace_back(std::forward<Args>(arguments)...);
+
+            SlotHandle handle = Allocate();
+            m_slots[handle.m_index].m_index = static_cast<uint32_t>(m_values.size() - 1);
+            m_valueSlots.push_back(handle.m_index);
+
+            return handle;
+        }
+
+        /**
+        \fn bool SlotMap<T>::erase(const SlotHandle& handle)
+        \brief Erases element referenced by \a handle.
+
+        Moves the last element into its place.
+        \return Whether \a handle referred to an element.
+        **/
+        template<typename T>
+        inline bool SlotMap<T>::erase(const SlotHandle& handle)
+        {
+            uint32_t index = Find(handle);
+            if (index == NoSlot)
+                return false;
+
+            uint32_t last = static_cast<uint32_t>(m_values.size() - 1);
+            if (index != last)
+            {
+                m_values[index] = std::move(m_values[last]);
+                m_valueSlots[index] = m_valueSlots[last];
+                m_slots[m_valueSlots[index]].m_index = index;
+            }
+
+            m_values.pop_back();
+            m_valueSlots.pop_back();
+
+            Slot& slot = m_slots[handle.m_index];
+            if (++slot.m_generation == 0)
+                slot.m_generation = 1;
+            slot.m_index = m_freeHead;
+            m_freeHead = handle.m_index;
+
+            return true;
+        }
+
+        /**
+        \fn void SlotMap<T>::clear()
+        \brief Erases every element, invalidating every handle.
+        **/
+        template<typename T>
+        inline void SlotMap<T>::clear()
+        {
+            while (!m_valueSlots.empty())
+            {
+                uint32_t slot = m_valueSlots.back();
+                erase(SlotHandle(slot, m_slots[slot].m_generation));
+            }
+        }
+
+        /**
+        \fn T* SlotMap<T>::get(const SlotHandle& handle)
+        \brief Returns element referenced by \a handle, or nullptr if it was erased.
+        **/
+        template<typename T>
+        inline T* SlotMap<T>::get(const SlotHandle& handle)
+        {
+            uint32_t index = Find(handle);
+            return index == NoSlot ? nullptr : &m_values[index];
+        }
+
+        /**
+        \fn const T* SlotMap<T>::get(const SlotHandle& handle) const
+        \brief Returns element referenced by \a handle, or nullptr if it was erased.
+        **/
+        template<typename T>
+        inline const T* SlotMap<T>::get(const SlotHandle& handle) const
+        {
+            uint32_t index = Find(handle);
+            return index == NoSlot ? nullptr : &m_values[index];
+        }
+
+        /**
+        \fn bool SlotMap<T>::contains(const SlotHandle& handle) const
+        \brief Returns whether \a handle refers to an element.
+        **/
+        template<typename T>
+        inline bool SlotMap<T>::contains(const SlotHandle& handle) const
+        {
+            return Find(handle) != NoSlot;
+        }
+
+        template<typename T>
+        inline typename SlotMap<T>::iterator SlotMap<T>::begin()
+        {
+            return m_values.begin();
+        }
+
+        template<typename T>
+        inline typename SlotMap<T>::iterator SlotMap<T>::end()
+        {
+            return m_values.end();
+        }
+
+        template<typename T>
+        inline typename SlotMap<T>::const_iterator SlotMap<T>::begin() const
+        {
+            return m_values.begin();
+        }
+
+        template<typename T>
+        inline typename SlotMap<T>::const_iterator SlotMap<T>::end() const
+        {
+            return m_values.end();
+        }
+
+        template<typename T>
+        inline size_t SlotMap<T>::size() const
+        {
+            return m_values.size();
+        }
+
+        template<typename T>
+        inline bool SlotMap<T>::empty() const
+        {
+            return m_values.empty();
+        }
+
+        /**
+        \fn SlotHandle SlotMap<T>::Allocate()
+        \brief Takes slot from the free list, or appends a new one.
+
+        Generations start at 1, so default constructed handles never match.
+        **/
+        template<typename T>
+        inline SlotHandle SlotMap<T>::Allocate()
+        {
+            if (m_freeHead != NoSlot)
+            {
+                uint32_t index = m_freeHead;
+                m_freeHead = m_slots[index].m_index;
+                return SlotHandle(index, m_slots[index].m_generation);
+            }
+
+            Slot slot;
+            slot.m_index = NoSlot;
+            slot.m_generation = 1;
+            m_slots.push_back(slot);
+
+            return SlotHandle(static_cast<uint32_t>(m_slots.size() - 1), slot.m_generation);
+        }
+
+        /**
+        \fn uint32_t SlotMap<T>::Find(const SlotHandle& handle) const
+        \brief Returns index of element referenced by \a handle, or NoSlot.
+        **/
+        template<typename T>
+        inline uint32_t SlotMap<T>::Find(const SlotHandle& handle) const
+        {
+            if (handle.m_index >= m_slots.size())
+                return NoSlot;
+
+            const Slot& slot = m_slots[handle.m_index];
+            if (slot.m_generation != handle.m_generation)
+                return NoSlot;
+
+            return slot.m_index;
+        }
+    }
+}
@@ -0,0 +1,253 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_spscqueue.h>
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \fn SPSCQueue<T>::SPSCQueue(size_t capacity)
+        \brief Creates empty queue holding up to \a capacity elements.
+
+        Capacity is rounded up to a power of two.
+        **/
+        template <typename T>
+        SPSCQueue<T>::SPSCQueue(size_t capacity)
+            : m_slots(),
+            m_mask(0),
+            m_tail(0),
+            m_cachedHead(0),
+            m_head(0),
+            m_cachedTail(0)
+        {
+            size_t size = 1;
+            while (size < capacity)
+                size <<= 1;
+
+            m_slots.reset(new Storage[size]);
+            m_mask = size - 1;
+        }
+
+        /**
+        \fn SPSCQueue<T>::~SPSCQueue()
+        \brief Destroys any elements left in the queue.
+        **/
+        template <typename T>
+        SPSCQueue<T>::~SPSCQueue()
+        {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            for (size_t index = m_head.load(std::memory_order_relaxed); index != tail; index++)
+                Slot(index)->~T();
+        }
+
+        /**
+        \fn bool SPSCQueue<T>::try_push(const T& _val)
+        \brief Copies \a _val into the queue unless it is full.  Producer only.
+        **/
+        template <typename T>
+        bool SPSCQueue<T>::try_push(const T& _val)
+        {
+            return Enqueue(_val);
+        }
+
+        /**
+        \fn bool SPSCQueue<T>::try_push(T&& _val)
+        \brief Moves \a _val into the queue unless it is full.  Producer only.
+        **/
+        template <typename T>
+        bool SPSCQueue<T>::try_push(T&& _val)
+        {
+            return Enqueue(std::move(_val));
+        }
+
+        /**
+        \fn bool SPSCQueue<T>::try_pop(T& out)
+        \brief Moves oldest element into \a out unless the queue is empty.  Consumer only.
+        **/
+        template <typename T>
+        bool SPSCQueue<T>::try_pop(T& out)
+        {
+            size_t head = m_head.load(std::memory_order_relaxed);
+            if (FilledSlots(head, 1) == 0)
+                return false;
+
+            T* value = Slot(head);
+            out = std::move(*value);
+            value->~T();
+
+            m_head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+        \fn size_t SPSCQueue<T>::try_push_batch(T* values, size_t count)
+        \brief Moves up to \a count elements from \a values into the queue.  Producer only.
+
+        Elements are published together once all of them are in place.  If
+        moving an element throws, the elements before it are published and
+        the exception is rethrown.
+        \return Number of elements moved, from the front of \a values.
+        **/
+        template <typename T>
+        size_t SPSCQueue<T>::try_push_batch(T* values, size_t count)
+        {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            count = FreeSlots(tail, count);
+
+            size_t i = 0;
+            try
+            {
+                for (; i < count; i++)
+                    new (Slot(tail + i)) T(std::move(values[i]));
+            }
+            catch (...)
+            {
+                //Publish what was constructed so those elements are not lost
+                m_tail.store(tail + i, std::memory_order_release);
+                throw;
+            }
+
+            m_tail.store(tail + count, std::memory_order_release);
+            return count;
+        }
+
+        /**
+        \fn size_t SPSCQueue<T>::try_pop_batch(T* out, size_t count)
+        \brief Moves up to \a count oldest elements into \a out.  Consumer only.
+
+        The slots are handed back to the producer together.
+        \return Number of elements moved into the front of \a out.
+        **/
+        template <typename T>
+        size_t SPSCQueue<T>::try_pop_batch(T* out, size_t count)
+        {
+            size_t head = m_head.load(std::memory_order_relaxed);
+            count = FilledSlots(head, count);
+
+            for (size_t i = 0; i < count; i++)
+            {
+                T* value = Slot(head + i);
+                out[i] = std::move(*value);
+                value->~T();
+            }
+
+            m_head.store(head + count, std::memory_order_release);
+            return count;
+        }
+
+        /**
+        \fn bool SPSCQueue<T>::empty() const
+        \brief Returns whether the queue held no elements when checked.
+        **/
+        template <typename T>
+        bool SPSCQueue<T>::empty() const
+        {
+            return size() == 0;
+        }
+
+        /**
+        \fn size_t SPSCQueue<T>::size() const
+        \brief Returns number of elements held when checked.
+        **/
+        template <typename T>
+        size_t SPSCQueue<T>::size() const
+        {
+            size_t head = m_head.load(std::memory_order_acquire);
+            size_t tail = m_tail.load(std::memory_order_acquire);
+            return tail - head;
+        }
+
+        /**
+        \fn size_t SPSCQueue<T>::capacity() const
+        \brief Returns maximum number of elements the queue can hold.
+        **/
+        template <typename T>
+        size_t SPSCQueue<T>::capacity() const
+        {
+            return m_mask + 1;
+        }
+
+        /**
+        \fn bool SPSCQueue<T>::Enqueue(U&& value)
+        \brief Constructs element from \a value at the tail unless the queue is full.
+        **/
+        template <typename T>
+        template <class U>
+        bool SPSCQueue<T>::Enqueue(U&& value)
+        {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (FreeSlots(tail, 1) == 0)
+                return false;
+
+            new (Slot(tail)) T(std::forward<U>(value));
+
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+        \fn size_t SPSCQueue<T>::FreeSlots(size_t tail, size_t wanted)
+        \brief Returns how many of \a wanted slots past \a tail the producer may fill.
+
+        Only reloads the consumer's index when the cached one does not
+        leave enough room.
+        **/
+        template <typename T>
+        size_t SPSCQueue<T>::FreeSlots(size_t tail, size_t wanted)
+        {
+            size_t free = capacity() - (tail - m_cachedHead);
+            if (free < wanted)
+            {
+                m_cachedHead = m_head.load(std::memory_order_acquire);
+                free = capacity() - (tail - m_cachedHead);
+            }
+
+            return free < wanted ? free : wanted;
+        }
+
+        /**
+        \fn size_t SPSCQueue<T>::FilledSlots(size_t head, size_t wanted)
+        \brief Returns how many of \a wanted slots from \a head the consumer may read.
+
+        Only reloads the producer's index when the cached one does not
+        cover enough elements.
+        **/
+        template <typename T>
+        size_t SPSCQueue<T>::FilledSlots(size_t head, size_t wanted)
+        {
+            size_t filled = m_cachedTail - head;
+            if (filled < wanted)
+            {
+                m_cachedTail = m_tail.load(std::memory_order_acquire);
+                filled = m_cachedTail - head;
+            }
+
+            return filled < wanted ? filled : wanted;
+        }
+
+        /**
+        \fn T* SPSCQueue<T>::Slot(size_t index)
+        \brief Returns storage of element at ring position \a index.
+        **/
+        template <typename T>
+        T* SPSCQueue<T>::Slot(size_t index)
+        {
+            return reinterpret_cast<T*>(&m_slots[index & m_mask]);
+        }
+    }
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <ht_task.h>
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \fn void TaskDispatcher::Dispatch(JobPriority priority, Func&& function)
+        \brief Runs \a function as a job with \a priority without waiting for RunJobs.
+        **/
+        template<class Func>
+        inline void TaskDispatcher::Dispatch(JobPriority priority, Func&& function)
+        {
+            Scheduler::SpawnJob(priority, std::forward<Func>(function));
+        }
+
+        /**
+        \fn std::coroutine_handle<> TaskPromiseBase::FinalAwaiter::await_suspend(std::coroutine_handle<Promise> coroutine)
+        \brief Transfers control to the awaiting coroutine, or signals completion.
+
+        The task may be destroyed as soon as completion is signaled, so the
+        promise is not touched afterwards.
+        **/
+        template<class Promise>
+        inline std::coroutine_handle<> TaskPromiseBase::FinalAwaiter::await_suspend(std::coroutine_handle<Promise> coroutine) noexcept
+        {
+            TaskPromiseBase& promise = coroutine.promise();
+            if (promise.m_continuation)
+                return promise.m_continuation;
+
+            JobHandle completion = promise.m_completion;
+            TaskDispatcher::Complete(completion);
+
+            return std::noop_coroutine();
+        }
+
+        template<typename T>
+        inline Task<T> TaskPromise<T>::get_return_object()
+        {
+            return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+        }
+
+        template<typename T>
+        template<typename U>
+        inline void TaskPromise<T>::return_value(U&& value)
+        {
+            m_value.emplace(std::forward<U>(value));
+        }
+
+        /**
+        \fn T TaskPromise<T>::GetResult()
+        \brief Moves out result of the finished task, or rethrows its exception.
+        **/
+        template<typename T>
+        inline T TaskPromise<T>::GetResult()
+        {
+            if (m_exception)
+                std::rethrow_exception(m_exception);
+
+            return std::move(*m_value);
+        }
+
+        inline Task<void> TaskPromise<void>::get_return_object()
+        {
+            return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+        }
+
+        /**
+        \fn void TaskPromise<void>::GetResult()
+        \brief Rethrows the exception of the finished task, if any.
+        **/
+        inline void TaskPromise<void>::GetResult()
+        {
+            if (m_exception)
+                std::rethrow_exception(m_exception);
+        }
+
+        template<typename T>
+        inline Task<T>::Task(std::coroutine_handle<promise_type> coroutine)
+            : m_coroutine(coroutine)
+        {}
+
+        template<typename T>
+        inline Task<T>::Task(Task&& rhs) noexcept
+            : m_coroutine(std::exchange(rhs.m_coroutine, nullptr))
+        {}
+
+        /**
+        \fn Task<T>::~Task()
+        \brief Destroys the coroutine frame.
+
+        A started task must have finished before it is destroyed.
+        **/
+        template<typename T>
+        inline Task<T>::~Task()
+        {
+            if (m_coroutine)
+                m_coroutine.destroy();
+        }
+
+        template<typename T>
+        inline Task<T>& Task<T>::operator=(Task&& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                if (m_coroutine)
+                    m_coroutine.destroy();
+                m_coroutine = std::exchange(rhs.m_coroutine, nullptr);
+            }
+
+            return *this;
+        }
+
+        template<typename T>
+        inline bool Task<T>::await_ready() const noexcept
+        {
+            return !m_coroutine || m_coroutine.done();
+        }
+
+        /**
+        \fn std::coroutine_handle<> Task<T>::await_suspend(std::coroutine_handle<> awaiting)
+        \brief Starts the task on the current thread, resuming \a awaiting when it finishes.
+        **/
+        template<typename T>
+        inline std::coroutine_handle<> Task<T>::await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            m_coroutine.promise().m_continuation = awaiting;
+
+            return m_coroutine;
+        }
+
+        template<typename T>
+        inline T Task<T>::await_resume()
+        {
+            return m_coroutine.promise().GetResult();
+        }
+
+        /**
+        \fn const JobHandle& Task<T>::Start(JobPriority priority)
+        \brief Starts the task as a job with \a priority.
+
+        Returns handle which completes once the task has finished.  Starting
+        a task more than once has no further effect.
+        **/
+        template<typename T>
+        inline const JobHandle& Task<T>::Start(JobPriority priority)
+        {
+            promise_type& promise = m_coroutine.promise();
+            if (!promise.m_completion.IsValid())
+            {
+                promise.m_completion = TaskDispatcher::CreateHandle();
+                TaskDispatcher::Resume(m_coroutine, priority);
+            }
+
+            return promise.m_completion;
+        }
+
+        /**
+        \fn T Task<T>::Get()
+        \brief Starts the task if needed, waits for it and returns its result.
+
+        The calling thread runs other jobs while it waits.
+        **/
+        template<typename T>
+        inline T Task<T>::Get()
+        {
+            Scheduler::WaitFor(Start(TaskDispatcher::GetCurrentPriority()));
+
+            return m_coroutine.promise().GetResult();
+        }
+
+        /**
+        \fn bool Task<T>::IsDone() const
+        \brief Returns whether the task has run to completion.
+        **/
+        template<typename T>
+        inline bool Task<T>::IsDone() const
+        {
+            return !m_coroutine || m_coroutine.done();
+        }
+    }
+}
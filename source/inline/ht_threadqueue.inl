@@ -109,14 +109,45 @@ namespace Hatchit
         template <typename T>
         void ThreadsafeQueue<T>::push(T _val)
         {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            m_data.push(std::move(_val));
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_data.push(std::move(_val));
+            }
+
+            //Notify after unlocking so the woken thread does not block on the mutex
             m_condition.notify_one();
         }
 
+        /**
+        \fn void ThreadsafeQueue<T>::push_range(InputIt first, InputIt last)
+        \brief Adds elements in [\a first, \a last) to current ThreadsafeQueue.
+
+        Elements are added under a single lock acquisition.  Use
+        std::make_move_iterator to move the elements instead of copying them.
+        **/
+        template <typename T>
+        template <class InputIt>
+        void ThreadsafeQueue<T>::push_range(InputIt first, InputIt last)
+        {
+            size_t count = 0;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (; first != last; ++first, ++count)
+                    m_data.push(*first);
+            }
+
+            if (count == 1)
+                m_condition.notify_one();
+            else if (count > 1)
+                m_condition.notify_all();
+        }
+
         /**
         \fn std::shared_ptr<T> ThreadsafeQueue<T>::wait_pop()
-        \brief Pops off first element in queue, and returns a shared ptr to temp copy of it.
+        \brief Pops off first element in queue, and returns a shared ptr holding it.
+
+        Allocates the shared ptr for every element; prefer the overloads
+        taking an output parameter.
         **/
         template <typename T>
         std::shared_ptr<T> ThreadsafeQueue<T>::wait_pop()
@@ -127,7 +158,7 @@ namespace Hatchit
             while (m_data.empty())
                 m_condition.wait(lock, [this] { return !m_data.empty(); });
 
-            std::shared_ptr<T> const result = std::make_shared<T>(m_data.front());
+            std::shared_ptr<T> const result = std::make_shared<T>(std::move(m_data.front()));
             m_data.pop();
 
             return result;
@@ -135,7 +166,7 @@ namespace Hatchit
 
         /**
         \fn void ThreadsafeQueue<T>::wait_pop(T& out)
-        \brief Removes last entry in queue and moves it into /a out param.
+        \brief Removes first entry in queue and moves it into \a out param.
         **/
         template <typename T>
         void ThreadsafeQueue<T>::wait_pop(T& out)
@@ -145,8 +176,100 @@ namespace Hatchit
             while (m_data.empty())
                 m_condition.wait(lock, [this] { return !m_data.empty();  });
 
-            out = m_data.front();
+            out = std::move(m_data.front());
+            m_data.pop();
+        }
+
+        /**
+        \fn bool ThreadsafeQueue<T>::try_pop(T& out)
+        \brief Moves first entry in queue into \a out param if there is one.
+
+        Never waits for an element to be pushed.
+        \return Whether an element was popped.
+        **/
+        template <typename T>
+        bool ThreadsafeQueue<T>::try_pop(T& out)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_data.empty())
+                return false;
+
+            out = std::move(m_data.front());
+            m_data.pop();
+
+            return true;
+        }
+
+        /**
+        \fn bool ThreadsafeQueue<T>::wait_pop_for(T& out, const std::chrono::duration<Rep, Period>& timeout)
+        \brief Moves first entry in queue into \a out param, waiting up to \a timeout for one.
+
+        \return Whether an element was popped before the timeout expired.
+        **/
+        template <typename T>
+        template <class Rep, class Period>
+        bool ThreadsafeQueue<T>::wait_pop_for(T& out, const std::chrono::duration<Rep, Period>& timeout)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!m_condition.wait_for(lock, timeout, [this] { return !m_data.empty(); }))
+                return false;
+
+            out = std::move(m_data.front());
             m_data.pop();
+
+            return true;
+        }
+
+        /**
+        \fn size_t ThreadsafeQueue<T>::drain(std::vector<T>& out)
+        \brief Moves every entry in queue to the back of \a out.
+
+        Never waits for an element to be pushed.
+        \return Number of elements moved.
+        **/
+        template <typename T>
+        size_t ThreadsafeQueue<T>::drain(std::vector<T>& out)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            return MoveAll(out);
+        }
+
+        /**
+        \fn size_t ThreadsafeQueue<T>::wait_drain(std::vector<T>& out)
+        \brief Waits until queue is not empty, then moves every entry to the back of \a out.
+
+        \return Number of elements moved, which is at least one.
+        **/
+        template <typename T>
+        size_t ThreadsafeQueue<T>::wait_drain(std::vector<T>& out)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return !m_data.empty(); });
+
+            return MoveAll(out);
+        }
+
+        /**
+        \fn size_t ThreadsafeQueue<T>::MoveAll(std::vector<T>& out)
+        \brief Moves every entry to the back of \a out.  Caller must hold the mutex.
+        **/
+        template <typename T>
+        size_t ThreadsafeQueue<T>::MoveAll(std::vector<T>& out)
+        {
+            size_t count = m_data.size();
+
+            //Only reserve for a fresh vector, so appending to the same vector keeps growing geometrically
+            if (out.empty())
+                out.reserve(count);
+
+            while (!m_data.empty())
+            {
+                out.push_back(std::move(m_data.front()));
+                m_data.pop();
+            }
+
+            return count;
         }
 
         /**
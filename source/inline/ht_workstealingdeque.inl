@@ -0,0 +1,210 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_workstealingdeque.h>
+#include <cassert>
+
+namespace Hatchit
+{
+    namespace Core
+    {
+        /**
+        \fn WorkStealingDeque<T>::Buffer::Buffer(int64_t capacity)
+        \brief Allocates circular buffer of \a capacity elements.
+
+        Capacity must be a power of two.
+        **/
+        template <typename T>
+        WorkStealingDeque<T>::Buffer::Buffer(int64_t capacity)
+            : m_capacity(capacity),
+            m_mask(capacity - 1),
+            m_data(new std::atomic<T>[static_cast<size_t>(capacity)])
+        {
+            assert((capacity & (capacity - 1)) == 0);
+        }
+
+        template <typename T>
+        WorkStealingDeque<T>::Buffer::~Buffer()
+        {
+            delete[] m_data;
+        }
+
+        template <typename T>
+        inline T WorkStealingDeque<T>::Buffer::Get(int64_t index) const
+        {
+            return m_data[index & m_mask].load(std::memory_order_relaxed);
+        }
+
+        template <typename T>
+        inline void WorkStealingDeque<T>::Buffer::Put(int64_t index, T value)
+        {
+            m_data[index & m_mask].store(value, std::memory_order_relaxed);
+        }
+
+        /**
+        \fn WorkStealingDeque<T>::Buffer* WorkStealingDeque<T>::Buffer::Grow(int64_t bottom, int64_t top) const
+        \brief Returns a buffer twice the size containing elements in [top, bottom).
+        **/
+        template <typename T>
+        typename WorkStealingDeque<T>::Buffer* WorkStealingDeque<T>::Buffer::Grow(int64_t bottom, int64_t top) const
+        {
+            Buffer* grown = new Buffer(m_capacity * 2);
+            for (int64_t i = top; i < bottom; i++)
+                grown->Put(i, Get(i));
+
+            return grown;
+        }
+
+        /**
+        \fn WorkStealingDeque<T>::WorkStealingDeque(int64_t capacity)
+        \brief Creates empty deque with room for \a capacity elements before growing.
+        **/
+        template <typename T>
+        WorkStealingDeque<T>::WorkStealingDeque(int64_t capacity)
+            : m_top(0),
+            m_bottom(0),
+            m_buffer(new Buffer(capacity)),
+            m_retired()
+        {
+            static_assert(std::is_trivially_copyable<T>::value,
+                "T is required to be trivially copyable");
+        }
+
+        /**
+        \fn WorkStealingDeque<T>::~WorkStealingDeque()
+        \brief Releases current and retired buffers.
+
+        Elements still inside the deque are not destroyed.
+        **/
+        template <typename T>
+        WorkStealingDeque<T>::~WorkStealingDeque()
+        {
+            delete m_buffer.load(std::memory_order_relaxed);
+            for (Buffer* buffer : m_retired)
+                delete buffer;
+        }
+
+        /**
+        \fn void WorkStealingDeque<T>::push(T _val)
+        \brief Pushes \a _val onto the bottom of the deque.
+
+        Must only be called by the owning thread.
+        **/
+        template <typename T>
+        void WorkStealingDeque<T>::push(T _val)
+        {
+            int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+            int64_t top = m_top.load(std::memory_order_acquire);
+            Buffer* buffer = m_buffer.load(std::memory_order_relaxed);
+
+            if (bottom - top > buffer->m_capacity - 1)
+            {
+                m_retired.push_back(buffer);
+                buffer = buffer->Grow(bottom, top);
+                m_buffer.store(buffer, std::memory_order_release);
+            }
+
+            buffer->Put(bottom, _val);
+            m_bottom.store(bottom + 1, std::memory_order_release);
+        }
+
+        /**
+        \fn bool WorkStealingDeque<T>::pop(T& out)
+        \brief Pops most recently pushed element into \a out.
+
+        Must only be called by the owning thread.  Returns false if the
+        deque was empty or the last element was stolen.
+        **/
+        template <typename T>
+        bool WorkStealingDeque<T>::pop(T& out)
+        {
+            int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+            Buffer* buffer = m_buffer.load(std::memory_order_relaxed);
+            m_bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = m_top.load(std::memory_order_relaxed);
+
+            if (top > bottom)
+            {
+                //Deque was empty
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            out = buffer->Get(bottom);
+            if (top == bottom)
+            {
+                //Last element, race against thieves for it
+                bool won = m_top.compare_exchange_strong(top, top + 1,
+                    std::memory_order_seq_cst, std::memory_order_relaxed);
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return won;
+            }
+
+            return true;
+        }
+
+        /**
+        \fn bool WorkStealingDeque<T>::steal(T& out)
+        \brief Steals oldest element into \a out.
+
+        May be called from any thread.  Returns false if the deque was
+        empty or another thread won the race for the element.
+        **/
+        template <typename T>
+        bool WorkStealingDeque<T>::steal(T& out)
+        {
+            int64_t top = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+            if (top >= bottom)
+                return false;
+
+            Buffer* buffer = m_buffer.load(std::memory_order_acquire);
+            T value = buffer->Get(top);
+            if (!m_top.compare_exchange_strong(top, top + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed))
+                return false;
+
+            out = value;
+            return true;
+        }
+
+        /**
+        \fn bool WorkStealingDeque<T>::empty() const
+        \brief Returns whether deque appeared empty at time of call.
+        **/
+        template <typename T>
+        bool WorkStealingDeque<T>::empty() const
+        {
+            return size() == 0;
+        }
+
+        /**
+        \fn size_t WorkStealingDeque<T>::size() const
+        \brief Returns approximate number of elements in deque.
+        **/
+        template <typename T>
+        size_t WorkStealingDeque<T>::size() const
+        {
+            int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+            int64_t top = m_top.load(std::memory_order_relaxed);
+
+            return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+        }
+    }
+}